@@ -0,0 +1,72 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include "ThreadPool.h"
+
+#include <functional>
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <iostream>
+
+// Streams assets in without freezing the window. Each job is split in two stages:
+//   work   - runs on a worker thread: file I/O, image decoding, Assimp import (no GL!)
+//   upload - returned by 'work', runs on the main thread inside PumpUploads (GL calls)
+// The main loop calls PumpUploads once per frame with a small time budget so the
+// GL uploads are spread over several frames.
+class AssetLoader {
+public:
+    using UploadStep = std::function<void()>;
+    using WorkStep = std::function<UploadStep()>;
+
+    explicit AssetLoader(unsigned int workerCount = ThreadPool::DefaultWorkerCount())
+        : total(0), completed(0), pool(workerCount) {}
+
+    // Queue a job; the loading screen reports progress as the share of jobs uploaded
+    void Enqueue(WorkStep work) {
+        total++;
+        pool.Submit([this, work]() {
+            UploadStep upload = work();
+            std::lock_guard<std::mutex> lock(mutex);
+            ready.push_back(std::move(upload));
+        });
+    }
+
+    // Run pending uploads on the calling (GL) thread until 'budgetSeconds' is used up.
+    // At least one upload runs per call so loading always makes progress.
+    int PumpUploads(double budgetSeconds) {
+        auto start = std::chrono::steady_clock::now();
+        int ran = 0;
+        for (;;) {
+            UploadStep upload;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (ready.empty()) break;
+                upload = std::move(ready.front());
+                ready.pop_front();
+            }
+
+            if (upload) upload();
+            completed++;
+            ran++;
+
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (elapsed.count() >= budgetSeconds) break;
+        }
+        return ran;
+    }
+
+    bool IsDone() const { return completed == total; }
+    int Total() const { return total; }
+    int Completed() const { return completed; }
+    float Progress() const { return total == 0 ? 1.0f : (float)completed / (float)total; }
+
+private:
+    std::mutex mutex;
+    std::deque<UploadStep> ready;
+    int total;      // main thread only
+    int completed;  // main thread only
+    ThreadPool pool; // declared last: joins its workers before the queue above is destroyed
+};
+
+#endif
@@ -7,6 +7,14 @@
 #include <iostream>
 #include <vector>
 
+// Decoded 16-bit PCM audio. Decoding touches no OpenAL state, so it can run on a worker thread.
+struct AudioClip {
+    std::string path;
+    std::vector<short> samples;
+    int channels = 0;
+    int sampleRate = 0;
+};
+
 class AudioManager {
 public:
     AudioManager();
@@ -18,6 +26,12 @@ public:
     // Load and play a music file (loops infinitely)
     bool PlayMusic(const std::string& filePath);
 
+    // Play already decoded music (loops infinitely)
+    bool PlayMusic(const AudioClip& clip);
+
+    // Decode an audio file to PCM without touching OpenAL (thread-safe)
+    static bool DecodeAudioFile(const std::string& filePath, AudioClip& clip);
+
     // Stop music
     void StopMusic();
 
@@ -51,4 +65,7 @@ private:
 
     // Helper to load WAV/FLAC/OGG file
     bool LoadAudioFile(const std::string& filePath, ALuint& buffer);
+
+    // Upload decoded PCM into an OpenAL buffer (generates the buffer if 0)
+    bool UploadClip(const AudioClip& clip, ALuint& buffer);
 };
@@ -0,0 +1,161 @@
+#ifndef BAKED_FONT_H
+#define BAKED_FONT_H
+
+#include "BakedModel.h"
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+
+// Disk cache for the distance fields GlyphCache generates, so glyphs a previous session already
+// drew skip FreeType and the distance transform. One file per font; written by the game itself
+// when it exits, under CacheDirectory (system fonts live in read-only folders, so not next to
+// the source).
+//
+// Layout (little-endian):
+//   FileHeader | GlyphRecord[glyphCount] | field pixels (R8, each glyph width x height)
+//
+// Like the other baked formats, the header records the size and timestamp of the font file;
+// a stale file, or one generated with different settings, is ignored and regenerated.
+namespace BakedFont {
+
+constexpr char Magic[4] = { 'T', 'O', 'B', 'F' };
+constexpr uint32_t Version = 3; // 3: blank glyphs are stored 0x0
+constexpr const char* Extension = ".tfnt";
+constexpr const char* CacheDirectory = "assets/cache";
+
+// One glyph: field size in texels, metrics in pixels at the size text is laid out for
+// (GlyphCache::NominalPixelSize)
+struct GlyphRecord {
+    uint32_t glyphIndex;  // FreeType glyph index in the font
+    uint16_t width;
+    uint16_t height;
+    float bearing[2];
+    float advance;
+    uint32_t pixelOffset; // from the start of the pixel block
+};
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    uint32_t pixelSize;    // size the fields were generated for
+    uint32_t spread;       // field range in texels
+    uint32_t supersample;  // rasterization factor
+    uint32_t nominalSize;  // size the metrics are in
+    uint32_t glyphCount;
+    uint32_t pixelBytes;
+};
+
+static_assert(sizeof(GlyphRecord) == 24, "GlyphRecord layout is part of the file format");
+static_assert(sizeof(FileHeader) == 48, "FileHeader layout is part of the file format");
+
+// The settings a set of fields was generated with; a file only loads for the same ones
+struct Settings {
+    uint32_t pixelSize;
+    uint32_t spread;
+    uint32_t supersample;
+    uint32_t nominalSize;
+};
+
+// A glyph in memory: its record (pixelOffset unused) and its field
+struct Glyph {
+    GlyphRecord record;
+    std::vector<unsigned char> pixels;
+};
+
+inline std::string PathFor(const std::string& fontPath, uint32_t pixelSize) {
+    std::string stem = std::filesystem::path(fontPath).stem().string();
+    return std::string(CacheDirectory) + "/" + stem + "-" + std::to_string(pixelSize) + "px-sdf" + Extension;
+}
+
+// Write 'glyphs' (generated from 'fontPath') to 'bakedPath', creating the cache folder if needed
+inline bool Write(const std::vector<const Glyph*>& glyphs, const Settings& settings, const std::string& fontPath,
+                  const std::string& bakedPath) {
+    FileHeader header = {};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.pixelSize = settings.pixelSize;
+    header.spread = settings.spread;
+    header.supersample = settings.supersample;
+    header.nominalSize = settings.nominalSize;
+    header.glyphCount = static_cast<uint32_t>(glyphs.size());
+    if (!BakedModel::SourceStamp(fontPath, header.sourceSize, header.sourceTime)) return false;
+
+    std::vector<GlyphRecord> records;
+    records.reserve(glyphs.size());
+    uint32_t pixelBytes = 0;
+    for (const Glyph* glyph : glyphs) {
+        GlyphRecord record = glyph->record;
+        record.pixelOffset = pixelBytes;
+        records.push_back(record);
+        pixelBytes += static_cast<uint32_t>(glyph->pixels.size());
+    }
+    header.pixelBytes = pixelBytes;
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(bakedPath).parent_path(), ec);
+    std::ofstream out(bakedPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Cannot write font cache " << bakedPath << std::endl;
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(sizeof(GlyphRecord) * records.size()));
+    for (const Glyph* glyph : glyphs) {
+        out.write(reinterpret_cast<const char*>(glyph->pixels.data()), static_cast<std::streamsize>(glyph->pixels.size()));
+    }
+    return static_cast<bool>(out);
+}
+
+// Load 'bakedPath' into 'out'. Fails if the file is missing, corrupt, from another format
+// version, older than 'fontPath', or generated with other settings.
+inline bool Read(const std::string& bakedPath, const std::string& fontPath, const Settings& settings,
+                 std::vector<Glyph>& out) {
+    MappedFile file;
+    if (!file.Open(bakedPath)) return false;
+    if (file.Size() < sizeof(FileHeader)) return false;
+
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(file.Data());
+    if (std::memcmp(header->magic, Magic, sizeof(Magic)) != 0 || header->version != Version ||
+        header->pixelSize != settings.pixelSize || header->spread != settings.spread ||
+        header->supersample != settings.supersample || header->nominalSize != settings.nominalSize) {
+        return false;
+    }
+
+    uint64_t sourceSize = 0;
+    int64_t sourceTime = 0;
+    if (!BakedModel::SourceStamp(fontPath, sourceSize, sourceTime) ||
+        sourceSize != header->sourceSize || sourceTime != header->sourceTime) {
+        std::cout << "Font cache is stale: " << bakedPath << std::endl;
+        return false;
+    }
+
+    uint64_t recordBytes = sizeof(GlyphRecord) * (uint64_t)header->glyphCount;
+    if (file.Size() != sizeof(FileHeader) + recordBytes + header->pixelBytes) return false;
+
+    const GlyphRecord* records = reinterpret_cast<const GlyphRecord*>(file.Data() + sizeof(FileHeader));
+    const unsigned char* pixels = file.Data() + sizeof(FileHeader) + recordBytes;
+    out.clear();
+    out.reserve(header->glyphCount);
+    for (uint32_t i = 0; i < header->glyphCount; ++i) {
+        const GlyphRecord& record = records[i];
+        uint64_t size = (uint64_t)record.width * record.height;
+        if ((uint64_t)record.pixelOffset + size > header->pixelBytes) return false;
+        Glyph glyph;
+        glyph.record = record;
+        glyph.pixels.assign(pixels + record.pixelOffset, pixels + record.pixelOffset + size);
+        out.push_back(std::move(glyph));
+    }
+    return true;
+}
+
+} // namespace BakedFont
+
+#endif
@@ -0,0 +1,334 @@
+#ifndef BAKED_MODEL_H
+#define BAKED_MODEL_H
+
+#include "MeshData.h"
+#include "PackedVertex.h"
+#include "MappedFile.h"
+#include "MaterialManifest.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <iostream>
+#include <algorithm>
+
+// Binary model format written by the asset_baker tool and memory-mapped at runtime.
+//
+// Layout (little-endian, every block 16-byte aligned):
+//   FileHeader | MeshRecord[meshCount] | vertex blocks | index blocks | string table
+//
+// Vertex blocks hold interleaved Vertex or PackedVertex structs (see MeshRecord::vertexFormat)
+// exactly as uploaded to the GPU, packed ones with their PositionQuantization, and index
+// blocks hold 16-bit (meshes up to 65536 vertices) or 32-bit triangle indices, already
+// optimized by MeshOptimizer, so the loader can hand pointers into the mapping straight
+// to glBufferData. A mesh's index block holds all of its LOD levels back to back, level 0
+// first, matching the single element buffer each Mesh uploads.
+//
+// The header records the size and timestamp of the source file and the MaterialManifest hash
+// of its texture entries; a baked file whose stamp no longer matches is stale and gets
+// re-imported.
+namespace BakedModel {
+
+constexpr char Magic[4] = { 'T', 'O', 'B', 'M' };
+// 2: optimized meshes, 16-bit indices; 3: LOD levels; 4: material hash; 5: bounding radius;
+// 6: diffuse variants; 7: packed vertices
+constexpr uint32_t Version = 7;
+constexpr uint32_t MaxTextures = 4;
+constexpr const char* Extension = ".tmesh";
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    uint32_t meshCount;
+    uint32_t vertexStride; // sizeof(Vertex) when baked, guards against Vertex layout changes
+    uint64_t meshTableOffset;
+    uint64_t stringTableOffset;
+    uint64_t stringTableSize;
+    uint64_t materialHash; // MaterialManifest::Hash of the source path at bake time
+};
+
+struct MeshRecord {
+    uint32_t nameOffset;                  // into the string table
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t textureCount;
+    uint32_t textureOffsets[MaxTextures]; // texture paths, into the string table
+    uint64_t vertexOffset;                // from start of file
+    uint64_t indexOffset;                 // from start of file
+    float diffuseColor[3];
+    float aabbMin[3];
+    float aabbMax[3];
+    uint32_t indexSize;                   // bytes per index: 2 or 4
+    uint32_t lodCount;                    // levels in the index block, including level 0
+    uint32_t lodIndexCounts[MaxLodLevels];
+    float lodErrors[MaxLodLevels];
+    float boundingRadius;                 // sphere around the AABB centre
+    uint32_t diffuseVariants;             // the first this many textures are alternative diffuse maps
+    uint32_t vertexFormat;                // VertexFormat of the vertex block
+    float posOffset[3];                   // PositionQuantization, Packed only
+    float posScale[3];
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader layout is part of the file format");
+static_assert(sizeof(MeshRecord) == 168, "MeshRecord layout is part of the file format");
+
+inline std::string PathFor(const std::string& sourcePath) {
+    return sourcePath + Extension;
+}
+
+// Size and modification time of the source file, used to detect stale baked files
+inline bool SourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& time) {
+    std::error_code ec;
+    auto fileSize = std::filesystem::file_size(sourcePath, ec);
+    if (ec) return false;
+    auto writeTime = std::filesystem::last_write_time(sourcePath, ec);
+    if (ec) return false;
+    size = static_cast<uint64_t>(fileSize);
+    time = static_cast<int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+// Indices of every LOD level in a mesh's index block
+inline uint64_t TotalIndexCount(const MeshRecord& rec) {
+    uint64_t total = 0;
+    for (uint32_t level = 0; level < rec.lodCount && level < (uint32_t)MaxLodLevels; ++level) {
+        total += rec.lodIndexCounts[level];
+    }
+    return total;
+}
+
+inline uint64_t AlignUp(uint64_t value, uint64_t alignment = 16) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+inline uint64_t VertexSize(const MeshRecord& rec) {
+    return rec.vertexFormat == (uint32_t)VertexFormat::Packed ? sizeof(PackedVertex) : sizeof(Vertex);
+}
+
+// Write 'model' (imported from 'model.path') to 'bakedPath', with its vertices in 'vertexFormat'
+inline bool Write(const ModelData& model, const std::string& bakedPath, VertexFormat vertexFormat = VertexFormat::Packed) {
+    FileHeader header = {};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.vertexStride = sizeof(Vertex);
+    header.meshCount = static_cast<uint32_t>(model.meshes.size());
+    header.materialHash = MaterialManifest::Instance().Hash(model.path);
+    if (!SourceStamp(model.path, header.sourceSize, header.sourceTime)) {
+        std::cerr << "Baker: cannot stat source " << model.path << std::endl;
+        return false;
+    }
+
+    // String table: offset 0 is always the empty string
+    std::vector<char> strings(1, '\0');
+    auto addString = [&strings](const std::string& str) {
+        uint32_t offset = static_cast<uint32_t>(strings.size());
+        strings.insert(strings.end(), str.begin(), str.end());
+        strings.push_back('\0');
+        return offset;
+    };
+
+    std::vector<MeshRecord> records(model.meshes.size());
+    std::vector<std::vector<PackedVertex>> packed(model.meshes.size());
+    uint64_t offset = AlignUp(sizeof(FileHeader));
+    header.meshTableOffset = offset;
+    offset = AlignUp(offset + sizeof(MeshRecord) * records.size());
+
+    for (size_t i = 0; i < model.meshes.size(); ++i) {
+        const MeshData& mesh = model.meshes[i];
+        MeshRecord& rec = records[i];
+        rec = {};
+        rec.nameOffset = addString(mesh.name);
+        rec.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+        rec.indexCount = static_cast<uint32_t>(mesh.indices.size());
+        rec.indexSize = UseShortIndices(mesh.vertices.size()) ? 2 : 4;
+        rec.lodCount = 1;
+        rec.lodIndexCounts[0] = rec.indexCount;
+        for (const MeshLod& lod : mesh.lods) {
+            if (rec.lodCount == (uint32_t)MaxLodLevels) break;
+            rec.lodIndexCounts[rec.lodCount] = static_cast<uint32_t>(lod.indices.size());
+            rec.lodErrors[rec.lodCount] = lod.error;
+            rec.lodCount++;
+        }
+        rec.textureCount = 0;
+        for (const auto& texture : mesh.texturePaths) {
+            if (rec.textureCount == MaxTextures) break;
+            rec.textureOffsets[rec.textureCount++] = addString(texture);
+        }
+        rec.diffuseVariants = std::min(mesh.diffuseVariants, rec.textureCount);
+        for (int c = 0; c < 3; ++c) {
+            rec.diffuseColor[c] = mesh.diffuseColor[c];
+            rec.aabbMin[c] = mesh.aabbMin[c];
+            rec.aabbMax[c] = mesh.aabbMax[c];
+        }
+        rec.boundingRadius = mesh.boundingRadius;
+        rec.vertexFormat = (uint32_t)vertexFormat;
+        PositionQuantization quantization;
+        if (vertexFormat == VertexFormat::Packed) {
+            quantization = PackVertices(mesh.vertices.data(), mesh.vertices.size(), packed[i]);
+        }
+        for (int c = 0; c < 3; ++c) {
+            rec.posOffset[c] = quantization.offset[c];
+            rec.posScale[c] = quantization.scale[c];
+        }
+        rec.vertexOffset = offset;
+        offset = AlignUp(offset + VertexSize(rec) * mesh.vertices.size());
+    }
+    for (size_t i = 0; i < model.meshes.size(); ++i) {
+        records[i].indexOffset = offset;
+        offset = AlignUp(offset + records[i].indexSize * (uint64_t)TotalIndexCount(records[i]));
+    }
+    header.stringTableOffset = offset;
+    header.stringTableSize = strings.size();
+
+    std::ofstream out(bakedPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Baker: cannot write " << bakedPath << std::endl;
+        return false;
+    }
+
+    auto writeAt = [&out](uint64_t position, const void* bytes, size_t count) {
+        // Zero-fill alignment padding up to 'position'
+        static const char zeros[16] = {};
+        uint64_t current = static_cast<uint64_t>(out.tellp());
+        while (current < position) {
+            size_t pad = static_cast<size_t>(position - current < 16 ? position - current : 16);
+            out.write(zeros, pad);
+            current += pad;
+        }
+        if (count > 0) out.write(static_cast<const char*>(bytes), count);
+    };
+
+    writeAt(0, &header, sizeof(header));
+    writeAt(header.meshTableOffset, records.data(), sizeof(MeshRecord) * records.size());
+    for (size_t i = 0; i < model.meshes.size(); ++i) {
+        if (vertexFormat == VertexFormat::Packed) {
+            writeAt(records[i].vertexOffset, packed[i].data(), sizeof(PackedVertex) * packed[i].size());
+        } else {
+            writeAt(records[i].vertexOffset, model.meshes[i].vertices.data(), sizeof(Vertex) * model.meshes[i].vertices.size());
+        }
+    }
+    for (size_t i = 0; i < model.meshes.size(); ++i) {
+        std::vector<unsigned int> indices = model.meshes[i].indices;
+        for (uint32_t level = 1; level < records[i].lodCount; ++level) {
+            const std::vector<unsigned int>& lodIndices = model.meshes[i].lods[level - 1].indices;
+            indices.insert(indices.end(), lodIndices.begin(), lodIndices.end());
+        }
+        if (records[i].indexSize == 2) {
+            std::vector<uint16_t> shortIndices = NarrowIndices(indices);
+            writeAt(records[i].indexOffset, shortIndices.data(), sizeof(uint16_t) * shortIndices.size());
+        } else {
+            writeAt(records[i].indexOffset, indices.data(), sizeof(uint32_t) * indices.size());
+        }
+    }
+    writeAt(header.stringTableOffset, strings.data(), strings.size());
+    return static_cast<bool>(out);
+}
+
+// Read-only view over a memory-mapped baked file. All accessors return pointers into the mapping.
+class View {
+public:
+    // Map and validate 'bakedPath'. Fails if the file is missing, corrupt, from another
+    // format version, older than 'sourcePath' (when the source still exists), or baked with
+    // different manifest materials.
+    bool Open(const std::string& bakedPath, const std::string& sourcePath) {
+        if (!file.Open(bakedPath)) return false;
+
+        if (file.Size() < sizeof(FileHeader)) return fail();
+        header = reinterpret_cast<const FileHeader*>(file.Data());
+        if (std::memcmp(header->magic, Magic, sizeof(Magic)) != 0 ||
+            header->version != Version || header->vertexStride != sizeof(Vertex)) {
+            return fail();
+        }
+
+        uint64_t sourceSize = 0;
+        int64_t sourceTime = 0;
+        if (SourceStamp(sourcePath, sourceSize, sourceTime) &&
+            (sourceSize != header->sourceSize || sourceTime != header->sourceTime)) {
+            std::cout << "Baked model is stale: " << bakedPath << std::endl;
+            return fail();
+        }
+        if (header->materialHash != MaterialManifest::Instance().Hash(sourcePath)) {
+            std::cout << "Baked model materials changed: " << bakedPath << std::endl;
+            return fail();
+        }
+
+        if (!inBounds(header->meshTableOffset, sizeof(MeshRecord) * (uint64_t)header->meshCount) ||
+            !inBounds(header->stringTableOffset, header->stringTableSize) ||
+            header->stringTableSize == 0 ||
+            file.Data()[header->stringTableOffset + header->stringTableSize - 1] != '\0') {
+            return fail();
+        }
+        for (uint32_t i = 0; i < header->meshCount; ++i) {
+            const MeshRecord& rec = mesh(i);
+            if ((rec.vertexFormat != (uint32_t)VertexFormat::Float && rec.vertexFormat != (uint32_t)VertexFormat::Packed) ||
+                !inBounds(rec.vertexOffset, VertexSize(rec) * rec.vertexCount) ||
+                (rec.indexSize != 2 && rec.indexSize != 4) ||
+                rec.lodCount == 0 || rec.lodCount > (uint32_t)MaxLodLevels || rec.lodIndexCounts[0] != rec.indexCount ||
+                !inBounds(rec.indexOffset, rec.indexSize * TotalIndexCount(rec)) ||
+                rec.nameOffset >= header->stringTableSize || rec.textureCount > MaxTextures ||
+                rec.diffuseVariants > rec.textureCount) {
+                return fail();
+            }
+            for (uint32_t t = 0; t < rec.textureCount; ++t) {
+                if (rec.textureOffsets[t] >= header->stringTableSize) return fail();
+            }
+        }
+        return true;
+    }
+
+    uint32_t meshCount() const { return header->meshCount; }
+
+    const MeshRecord& mesh(uint32_t i) const {
+        return reinterpret_cast<const MeshRecord*>(file.Data() + header->meshTableOffset)[i];
+    }
+
+    // Vertex or PackedVertex structs, see MeshRecord::vertexFormat
+    const void* vertices(uint32_t i) const {
+        return file.Data() + mesh(i).vertexOffset;
+    }
+
+    VertexFormat vertexFormat(uint32_t i) const {
+        return static_cast<VertexFormat>(mesh(i).vertexFormat);
+    }
+
+    PositionQuantization quantization(uint32_t i) const {
+        const MeshRecord& rec = mesh(i);
+        PositionQuantization q;
+        q.offset = glm::vec3(rec.posOffset[0], rec.posOffset[1], rec.posOffset[2]);
+        q.scale = glm::vec3(rec.posScale[0], rec.posScale[1], rec.posScale[2]);
+        return q;
+    }
+
+    // uint16_t or uint32_t indices, see MeshRecord::indexSize. All LOD levels follow level 0.
+    const void* indices(uint32_t i) const {
+        return file.Data() + mesh(i).indexOffset;
+    }
+
+    const char* string(uint32_t offset) const {
+        return reinterpret_cast<const char*>(file.Data() + header->stringTableOffset + offset);
+    }
+
+private:
+    MappedFile file;
+    const FileHeader* header = nullptr;
+
+    bool inBounds(uint64_t offset, uint64_t length) const {
+        return offset <= file.Size() && length <= file.Size() - offset;
+    }
+
+    bool fail() {
+        file.Close();
+        header = nullptr;
+        return false;
+    }
+};
+
+} // namespace BakedModel
+
+#endif
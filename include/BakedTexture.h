@@ -0,0 +1,205 @@
+#ifndef BAKED_TEXTURE_H
+#define BAKED_TEXTURE_H
+
+#include "ImageLoader.h"
+#include "BakedModel.h"
+#include "MappedFile.h"
+#include "BlockCompression.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <fstream>
+#include <iostream>
+
+// Binary texture format written by the asset_baker tool next to the source image as
+// <source>.ttex, holding the complete mip chain so the runtime uploads every level as-is
+// instead of calling glGenerateMipmap.
+//
+// Layout (little-endian, every block 16-byte aligned):
+//   FileHeader | level 0 pixels | level 1 pixels | ... | last level (1x1)
+//
+// Levels are tightly packed rows, or 4x4 blocks for the BC formats, in the header's pixel
+// format. Like BakedModel, the header records the size and timestamp of the source image; a
+// stale file is ignored and the image is decoded from source instead.
+namespace BakedTexture {
+
+constexpr char Magic[4] = { 'T', 'O', 'B', 'T' };
+constexpr uint32_t Version = 2; // 2: BC1/BC3/BC7 levels
+constexpr uint32_t MaxLevels = 16; // up to 32768 x 32768
+constexpr const char* Extension = ".ttex";
+
+// Pixel layout of every level
+enum PixelFormat : uint32_t {
+    R8 = 1,
+    RG8 = 2,
+    RGB8 = 3,
+    RGBA8 = 4,
+    BC1 = 16,
+    BC3 = 17,
+    BC7 = 18,
+};
+
+enum Flags : uint32_t {
+    FlagSrgb = 1 << 0, // colour channels are sRGB-encoded (alpha never is)
+};
+
+struct LevelRecord {
+    uint64_t offset; // from start of file
+    uint64_t size;   // bytes
+};
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;     // PixelFormat
+    uint32_t flags;      // Flags
+    uint32_t levelCount; // including level 0
+    uint32_t reserved;
+    LevelRecord levels[MaxLevels];
+};
+
+static_assert(sizeof(FileHeader) == 304, "FileHeader layout is part of the file format");
+
+inline std::string PathFor(const std::string& sourcePath) {
+    return sourcePath + Extension;
+}
+
+inline BlockFormat BlockFormatOf(uint32_t format) {
+    if (format == BC1) return BlockFormat::BC1;
+    if (format == BC3) return BlockFormat::BC3;
+    if (format == BC7) return BlockFormat::BC7;
+    return BlockFormat::None;
+}
+
+inline bool IsValidFormat(uint32_t format) {
+    return (format >= R8 && format <= RGBA8) || BlockFormatOf(format) != BlockFormat::None;
+}
+
+// Bytes of one level in 'format'
+inline uint64_t LevelBytes(uint32_t format, int width, int height) {
+    BlockFormat block = BlockFormatOf(format);
+    if (block != BlockFormat::None) return BlockCompression::LevelBytes(block, width, height);
+    return (uint64_t)width * height * format;
+}
+
+// Write 'image' (decoded from 'sourcePath', mips already built) to 'bakedPath'. A source that
+// doesn't exist (the image is a stand-in for a missing file) gets a zero stamp; Read skips
+// the stale check for missing sources anyway.
+inline bool Write(const ImageData& image, const std::string& sourcePath, const std::string& bakedPath) {
+    if (!image.valid() || image.mips.size() + 1 > MaxLevels) return false;
+
+    FileHeader header = {};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.width = static_cast<uint32_t>(image.width);
+    header.height = static_cast<uint32_t>(image.height);
+    switch (image.block) {
+    case BlockFormat::BC1: header.format = BC1; break;
+    case BlockFormat::BC3: header.format = BC3; break;
+    case BlockFormat::BC7: header.format = BC7; break;
+    default: header.format = static_cast<uint32_t>(image.channels); break;
+    }
+    header.flags = image.srgb ? FlagSrgb : 0;
+    header.levelCount = static_cast<uint32_t>(image.mips.size() + 1);
+    if (!BakedModel::SourceStamp(sourcePath, header.sourceSize, header.sourceTime) &&
+        std::filesystem::exists(sourcePath)) {
+        std::cerr << "Baker: cannot stat source " << sourcePath << std::endl;
+        return false;
+    }
+
+    uint64_t offset = BakedModel::AlignUp(sizeof(FileHeader));
+    for (uint32_t level = 0; level < header.levelCount; ++level) {
+        const std::vector<unsigned char>& pixels = level == 0 ? image.pixels : image.mips[level - 1];
+        header.levels[level].offset = offset;
+        header.levels[level].size = pixels.size();
+        offset = BakedModel::AlignUp(offset + pixels.size());
+    }
+
+    std::ofstream out(bakedPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Baker: cannot write " << bakedPath << std::endl;
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (uint32_t level = 0; level < header.levelCount; ++level) {
+        const std::vector<unsigned char>& pixels = level == 0 ? image.pixels : image.mips[level - 1];
+        static const char zeros[16] = {};
+        uint64_t current = static_cast<uint64_t>(out.tellp());
+        out.write(zeros, static_cast<std::streamsize>(header.levels[level].offset - current));
+        out.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+    }
+    return static_cast<bool>(out);
+}
+
+// Load 'bakedPath' into 'out' (all levels). Fails if the file is missing, corrupt, from
+// another format version, or older than 'sourcePath' (when the source still exists).
+inline bool Read(const std::string& bakedPath, const std::string& sourcePath, ImageData& out) {
+    MappedFile file;
+    if (!file.Open(bakedPath)) return false;
+    if (file.Size() < sizeof(FileHeader)) return false;
+
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(file.Data());
+    if (std::memcmp(header->magic, Magic, sizeof(Magic)) != 0 || header->version != Version ||
+        !IsValidFormat(header->format) || header->width == 0 || header->height == 0 ||
+        header->levelCount == 0 || header->levelCount > MaxLevels) {
+        return false;
+    }
+
+    uint64_t sourceSize = 0;
+    int64_t sourceTime = 0;
+    if (BakedModel::SourceStamp(sourcePath, sourceSize, sourceTime) &&
+        (sourceSize != header->sourceSize || sourceTime != header->sourceTime)) {
+        std::cout << "Baked texture is stale: " << bakedPath << std::endl;
+        return false;
+    }
+
+    for (uint32_t level = 0; level < header->levelCount; ++level) {
+        const LevelRecord& rec = header->levels[level];
+        uint64_t expected = LevelBytes(header->format, ImageData::MipSize(header->width, level),
+                                       ImageData::MipSize(header->height, level));
+        if (rec.size != expected || rec.offset > file.Size() || rec.size > file.Size() - rec.offset) {
+            return false;
+        }
+    }
+
+    out.width = static_cast<int>(header->width);
+    out.height = static_cast<int>(header->height);
+    out.block = BlockFormatOf(header->format);
+    out.channels = out.block != BlockFormat::None ? 4 : static_cast<int>(header->format);
+    out.srgb = (header->flags & FlagSrgb) != 0;
+    const unsigned char* base = file.Data();
+    out.pixels.assign(base + header->levels[0].offset, base + header->levels[0].offset + header->levels[0].size);
+    out.mips.resize(header->levelCount - 1);
+    for (uint32_t level = 1; level < header->levelCount; ++level) {
+        const LevelRecord& rec = header->levels[level];
+        out.mips[level - 1].assign(base + rec.offset, base + rec.offset + rec.size);
+    }
+    return true;
+}
+
+// Read 'bakedPath' for upload. Block-compressed data the GPU can't sample is transcoded to
+// RGBA here, on the calling (loader) thread.
+inline bool Load(const std::string& bakedPath, const std::string& sourcePath, ImageData& out) {
+    if (!Read(bakedPath, sourcePath, out)) return false;
+    if (out.block != BlockFormat::None && !BlockCompression::GpuSupports(out.block)) {
+        std::cout << "No GPU support for " << BlockCompression::FormatName(out.block)
+                  << ", transcoding on the CPU: " << bakedPath << std::endl;
+        BlockCompression::Decompress(out);
+    }
+    return true;
+}
+
+// Decode 'path' for upload: the baked texture (with its mip chain) when an up-to-date one
+// exists (see Load), otherwise the source image
+inline bool Decode(const std::string& path, ImageData& out) {
+    return Load(PathFor(path), path, out) || ImageLoader::Decode(path, out);
+}
+
+} // namespace BakedTexture
+
+#endif
@@ -0,0 +1,701 @@
+#ifndef BLOCK_COMPRESSION_H
+#define BLOCK_COMPRESSION_H
+
+#include "ImageLoader.h"
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+
+// BC1 / BC3 / BC7 (S3TC and BPTC) texture block compression. CPU only.
+//
+// asset_baker encodes baked textures offline (BC1 and BC3 with a principal-axis fit, BC7 in
+// mode 6: one subset, RGBA endpoints, 4-bit indices). The decoders handle every valid block
+// of each format and are the fallback when the GL driver lacks the matching extension: the
+// texture is transcoded to RGBA and uploaded uncompressed.
+namespace BlockCompression {
+
+// Which formats the GL context can sample directly. Filled in on the main thread by
+// TextureCache::DetectCompressionSupport(); read by loader threads to decide whether to
+// transcode a baked texture before upload.
+inline std::atomic<bool> SupportsS3tc{ false };
+inline std::atomic<bool> SupportsBptc{ false };
+
+inline bool GpuSupports(BlockFormat format) {
+    if (format == BlockFormat::BC1 || format == BlockFormat::BC3) return SupportsS3tc.load();
+    if (format == BlockFormat::BC7) return SupportsBptc.load();
+    return true;
+}
+
+inline const char* FormatName(BlockFormat format) {
+    switch (format) {
+    case BlockFormat::BC1: return "BC1";
+    case BlockFormat::BC3: return "BC3";
+    case BlockFormat::BC7: return "BC7";
+    default: return "RGBA";
+    }
+}
+
+inline size_t BlockBytes(BlockFormat format) {
+    return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+// Bytes of one compressed level; partial blocks at the edges still take a whole block
+inline size_t LevelBytes(BlockFormat format, int width, int height) {
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * BlockBytes(format);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Shared helpers
+// ---------------------------------------------------------------------------------------------
+
+// Little-endian bit reader/writer over one 16-byte block
+struct BlockBits {
+    uint8_t* bytes;
+    int position = 0;
+
+    explicit BlockBits(uint8_t* block) : bytes(block) {}
+
+    uint32_t read(int count) {
+        uint32_t value = 0;
+        for (int i = 0; i < count; ++i, ++position) {
+            value |= (uint32_t)((bytes[position >> 3] >> (position & 7)) & 1) << i;
+        }
+        return value;
+    }
+
+    void write(uint32_t value, int count) {
+        for (int i = 0; i < count; ++i, ++position) {
+            if ((value >> i) & 1) bytes[position >> 3] |= (uint8_t)(1 << (position & 7));
+        }
+    }
+};
+
+// Copy the 4x4 block at (bx, by) from tightly packed 'channels' pixels into RGBA, repeating the
+// last row/column where the image doesn't cover the whole block
+inline void FetchBlock(const uint8_t* pixels, int width, int height, int channels, int bx, int by, uint8_t rgba[64]) {
+    for (int y = 0; y < 4; ++y) {
+        int sy = std::min(by * 4 + y, height - 1);
+        for (int x = 0; x < 4; ++x) {
+            int sx = std::min(bx * 4 + x, width - 1);
+            const uint8_t* p = pixels + ((size_t)sy * width + sx) * channels;
+            uint8_t* out = rgba + (y * 4 + x) * 4;
+            if (channels >= 3) {
+                out[0] = p[0]; out[1] = p[1]; out[2] = p[2];
+            } else {
+                out[0] = out[1] = out[2] = p[0];
+            }
+            out[3] = channels == 4 ? p[3] : (channels == 2 ? p[1] : 255);
+        }
+    }
+}
+
+// Principal axis of 'count' points with 'dims' components (power iteration on the covariance)
+inline void PrincipalAxis(const float* points, int count, int dims, float* mean, float* axis) {
+    for (int d = 0; d < dims; ++d) {
+        mean[d] = 0.0f;
+        for (int i = 0; i < count; ++i) mean[d] += points[i * dims + d];
+        mean[d] /= count;
+    }
+    float cov[4][4] = {};
+    for (int i = 0; i < count; ++i) {
+        for (int a = 0; a < dims; ++a) {
+            for (int b = 0; b < dims; ++b) {
+                cov[a][b] += (points[i * dims + a] - mean[a]) * (points[i * dims + b] - mean[b]);
+            }
+        }
+    }
+    for (int d = 0; d < dims; ++d) axis[d] = 1.0f;
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        float next[4] = {};
+        for (int a = 0; a < dims; ++a) {
+            for (int b = 0; b < dims; ++b) next[a] += cov[a][b] * axis[b];
+        }
+        float length = 0.0f;
+        for (int d = 0; d < dims; ++d) length += next[d] * next[d];
+        length = std::sqrt(length);
+        if (length < 1e-8f) break; // flat block: keep the current axis
+        for (int d = 0; d < dims; ++d) axis[d] = next[d] / length;
+    }
+}
+
+// Endpoints spanning the projection of the points onto their principal axis
+inline void FitEndpoints(const float* points, int count, int dims, float* e0, float* e1) {
+    float mean[4], axis[4];
+    PrincipalAxis(points, count, dims, mean, axis);
+    float minT = 1e30f, maxT = -1e30f;
+    for (int i = 0; i < count; ++i) {
+        float t = 0.0f;
+        for (int d = 0; d < dims; ++d) t += (points[i * dims + d] - mean[d]) * axis[d];
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    for (int d = 0; d < dims; ++d) {
+        e0[d] = std::min(std::max(mean[d] + axis[d] * minT, 0.0f), 255.0f);
+        e1[d] = std::min(std::max(mean[d] + axis[d] * maxT, 0.0f), 255.0f);
+    }
+}
+
+// Least-squares endpoints for fixed interpolation weights t[i] in [0, 1]; returns false if
+// the weights are degenerate (all the same)
+inline bool RefineEndpoints(const float* points, const float* t, int count, int dims, float* e0, float* e1) {
+    float aa = 0, ab = 0, bb = 0;
+    float ax[4] = {}, bx[4] = {};
+    for (int i = 0; i < count; ++i) {
+        float a = 1.0f - t[i], b = t[i];
+        aa += a * a; ab += a * b; bb += b * b;
+        for (int d = 0; d < dims; ++d) {
+            ax[d] += a * points[i * dims + d];
+            bx[d] += b * points[i * dims + d];
+        }
+    }
+    float det = aa * bb - ab * ab;
+    if (std::fabs(det) < 1e-6f) return false;
+    for (int d = 0; d < dims; ++d) {
+        e0[d] = std::min(std::max((ax[d] * bb - bx[d] * ab) / det, 0.0f), 255.0f);
+        e1[d] = std::min(std::max((bx[d] * aa - ax[d] * ab) / det, 0.0f), 255.0f);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------
+// BC1 / BC3
+// ---------------------------------------------------------------------------------------------
+
+inline uint16_t Pack565(const float* c) {
+    int r = (int)(c[0] * 31.0f / 255.0f + 0.5f);
+    int g = (int)(c[1] * 63.0f / 255.0f + 0.5f);
+    int b = (int)(c[2] * 31.0f / 255.0f + 0.5f);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+inline void Unpack565(uint16_t c, int* rgb) {
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+// Four-colour palette (c0 > c1 ordering is the caller's job)
+inline void Bc1Palette(uint16_t c0, uint16_t c1, bool fourColor, int palette[4][4]) {
+    Unpack565(c0, palette[0]);
+    Unpack565(c1, palette[1]);
+    palette[0][3] = palette[1][3] = 255;
+    for (int c = 0; c < 3; ++c) {
+        if (fourColor) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        } else {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+    palette[2][3] = 255;
+    palette[3][3] = fourColor ? 255 : 0;
+}
+
+// Opaque colour block (always four-colour mode, so it is also valid inside BC3)
+inline void EncodeColorBlock(const uint8_t rgba[64], uint8_t out[8]) {
+    float points[16 * 3];
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 3; ++c) points[i * 3 + c] = rgba[i * 4 + c];
+    }
+
+    auto encodeWith = [&](const float* e0, const float* e1, uint8_t block[8]) {
+        uint16_t c0 = Pack565(e1), c1 = Pack565(e0); // e1 is the "max" end
+        if (c0 < c1) std::swap(c0, c1);
+        int palette[4][4];
+        Bc1Palette(c0, c1, true, palette);
+        uint32_t indices = 0;
+        int error = 0;
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestDistance = 1 << 30;
+            for (int p = 0; p < 4; ++p) {
+                int d = 0;
+                for (int c = 0; c < 3; ++c) {
+                    int diff = palette[p][c] - rgba[i * 4 + c];
+                    d += diff * diff;
+                }
+                if (d < bestDistance) {
+                    bestDistance = d;
+                    best = p;
+                }
+            }
+            // Equal endpoints: every index must be 0 or 1 to stay in four-colour mode
+            if (c0 == c1) best = 0;
+            indices |= (uint32_t)best << (i * 2);
+            error += bestDistance;
+        }
+        block[0] = (uint8_t)(c0 & 0xff); block[1] = (uint8_t)(c0 >> 8);
+        block[2] = (uint8_t)(c1 & 0xff); block[3] = (uint8_t)(c1 >> 8);
+        std::memcpy(block + 4, &indices, 4);
+        return error;
+    };
+
+    float e0[3], e1[3];
+    FitEndpoints(points, 16, 3, e0, e1);
+    int bestError = encodeWith(e0, e1, out);
+
+    // One least-squares pass on the chosen indices
+    float t[16];
+    uint32_t indices;
+    std::memcpy(&indices, out + 4, 4);
+    uint16_t c0 = (uint16_t)(out[0] | (out[1] << 8)), c1 = (uint16_t)(out[2] | (out[3] << 8));
+    if (c0 != c1) {
+        const float weight[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+        for (int i = 0; i < 16; ++i) t[i] = weight[(indices >> (i * 2)) & 3];
+        float r0[3], r1[3];
+        if (RefineEndpoints(points, t, 16, 3, r0, r1)) {
+            uint8_t candidate[8];
+            // t = 0 is palette[0] (c0), so r0 maps to c0: pass it as the "max" end
+            int error = encodeWith(r1, r0, candidate);
+            if (error < bestError) std::memcpy(out, candidate, 8);
+        }
+    }
+}
+
+inline void EncodeAlphaBlock(const uint8_t rgba[64], uint8_t out[8]) {
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; ++i) {
+        a0 = std::max(a0, (int)rgba[i * 4 + 3]);
+        a1 = std::min(a1, (int)rgba[i * 4 + 3]);
+    }
+    out[0] = (uint8_t)a0;
+    out[1] = (uint8_t)a1;
+    uint64_t indices = 0;
+    if (a0 > a1) {
+        int palette[8] = { a0, a1 };
+        for (int i = 1; i < 7; ++i) palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestDistance = 1 << 30;
+            for (int p = 0; p < 8; ++p) {
+                int d = std::abs(palette[p] - rgba[i * 4 + 3]);
+                if (d < bestDistance) {
+                    bestDistance = d;
+                    best = p;
+                }
+            }
+            indices |= (uint64_t)best << (i * 3);
+        }
+    }
+    for (int b = 0; b < 6; ++b) out[2 + b] = (uint8_t)(indices >> (b * 8));
+}
+
+inline void DecodeColorBlock(const uint8_t block[8], bool allowThreeColor, uint8_t rgba[64]) {
+    uint16_t c0 = (uint16_t)(block[0] | (block[1] << 8));
+    uint16_t c1 = (uint16_t)(block[2] | (block[3] << 8));
+    uint32_t indices;
+    std::memcpy(&indices, block + 4, 4);
+    int palette[4][4];
+    Bc1Palette(c0, c1, !allowThreeColor || c0 > c1, palette);
+    for (int i = 0; i < 16; ++i) {
+        const int* color = palette[(indices >> (i * 2)) & 3];
+        for (int c = 0; c < 4; ++c) rgba[i * 4 + c] = (uint8_t)color[c];
+    }
+}
+
+inline void DecodeAlphaBlock(const uint8_t block[8], uint8_t rgba[64]) {
+    int a0 = block[0], a1 = block[1];
+    int palette[8] = { a0, a1 };
+    if (a0 > a1) {
+        for (int i = 1; i < 7; ++i) palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+    } else {
+        for (int i = 1; i < 5; ++i) palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+    uint64_t indices = 0;
+    for (int b = 0; b < 6; ++b) indices |= (uint64_t)block[2 + b] << (b * 8);
+    for (int i = 0; i < 16; ++i) rgba[i * 4 + 3] = (uint8_t)palette[(indices >> (i * 3)) & 7];
+}
+
+// ---------------------------------------------------------------------------------------------
+// BC7
+// ---------------------------------------------------------------------------------------------
+
+struct Bc7Mode {
+    int subsets, partitionBits, rotationBits, indexSelectionBits;
+    int colorBits, alphaBits, endpointPBits, sharedPBits, indexBits, secondaryIndexBits;
+};
+
+inline const Bc7Mode Bc7Modes[8] = {
+    { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+    { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+    { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+    { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+    { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+    { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+    { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+    { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+};
+
+inline const int Bc7Weights2[4] = { 0, 21, 43, 64 };
+inline const int Bc7Weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+inline const int Bc7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+inline const int* Bc7WeightTable(int bits) {
+    return bits == 2 ? Bc7Weights2 : (bits == 3 ? Bc7Weights3 : Bc7Weights4);
+}
+
+// Two-subset partitions: bit i set = pixel i belongs to subset 1
+inline const uint16_t Bc7Partitions2[64] = {
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+    0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+    0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+    0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+    0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+};
+
+inline const uint8_t Bc7Partitions3[64][16] = {
+    { 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2 }, { 0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1 },
+    { 0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1 }, { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2 }, { 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2 },
+    { 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1 }, { 0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2 }, { 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2 },
+    { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2 }, { 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2 },
+    { 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2 }, { 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2 },
+    { 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2 }, { 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0 },
+    { 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2 }, { 0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0 },
+    { 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2 }, { 0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1 },
+    { 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2 }, { 0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1 },
+    { 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2 }, { 0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0 },
+    { 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0 }, { 0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2 },
+    { 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0 }, { 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1 },
+    { 0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2 }, { 0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2 },
+    { 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1 }, { 0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1 },
+    { 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2 }, { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1 },
+    { 0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2 }, { 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0 },
+    { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0 }, { 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0 },
+    { 0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0 }, { 0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1 },
+    { 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1 }, { 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1 }, { 0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2 },
+    { 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1 }, { 0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1 },
+    { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1 }, { 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1 },
+    { 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2 }, { 0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1 },
+    { 0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2 }, { 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2 },
+    { 0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2 }, { 0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2 },
+    { 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2 }, { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2 },
+    { 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2 }, { 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2 },
+    { 0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2 },
+    { 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1 }, { 0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2 },
+    { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2 }, { 0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0 },
+};
+
+// Anchor pixel (index stored with one bit less) of subset 1 in two-subset partitions
+inline const uint8_t Bc7Anchors2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+    15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+     6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15,
+};
+
+// Anchor pixels of subsets 1 and 2 in three-subset partitions
+inline const uint8_t Bc7Anchors3a[64] = {
+     3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+     3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+     8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+     3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3,
+};
+
+inline const uint8_t Bc7Anchors3b[64] = {
+    15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+    15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+    15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+    15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8,
+};
+
+inline int Bc7Subset(int subsets, int partition, int pixel) {
+    if (subsets == 2) return (Bc7Partitions2[partition] >> pixel) & 1;
+    if (subsets == 3) return Bc7Partitions3[partition][pixel];
+    return 0;
+}
+
+inline bool Bc7IsAnchor(int subsets, int partition, int pixel) {
+    if (pixel == 0) return true;
+    if (subsets == 2) return pixel == Bc7Anchors2[partition];
+    if (subsets == 3) return pixel == Bc7Anchors3a[partition] || pixel == Bc7Anchors3b[partition];
+    return false;
+}
+
+inline int Bc7Interpolate(int e0, int e1, int weight) {
+    return ((64 - weight) * e0 + weight * e1 + 32) >> 6;
+}
+
+inline void DecodeBc7Block(const uint8_t block[16], uint8_t rgba[64]) {
+    uint8_t copy[16];
+    std::memcpy(copy, block, 16);
+    BlockBits bits(copy);
+
+    int modeIndex = 0;
+    while (modeIndex < 8 && bits.read(1) == 0) modeIndex++;
+    if (modeIndex == 8) {
+        // Reserved mode: transparent black
+        std::memset(rgba, 0, 64);
+        return;
+    }
+    const Bc7Mode& mode = Bc7Modes[modeIndex];
+
+    int partition = (int)bits.read(mode.partitionBits);
+    int rotation = (int)bits.read(mode.rotationBits);
+    int indexSelection = (int)bits.read(mode.indexSelectionBits);
+
+    // endpoints[subset * 2 + end][channel]
+    int endpoints[6][4] = {};
+    const int endpointCount = mode.subsets * 2;
+    for (int c = 0; c < 3; ++c) {
+        for (int e = 0; e < endpointCount; ++e) endpoints[e][c] = (int)bits.read(mode.colorBits);
+    }
+    for (int e = 0; e < endpointCount; ++e) endpoints[e][3] = mode.alphaBits ? (int)bits.read(mode.alphaBits) : 255;
+
+    int colorBits = mode.colorBits;
+    int alphaBits = mode.alphaBits;
+    if (mode.endpointPBits || mode.sharedPBits) {
+        int pbits[6];
+        if (mode.endpointPBits) {
+            for (int e = 0; e < endpointCount; ++e) pbits[e] = (int)bits.read(1);
+        } else {
+            for (int s = 0; s < mode.subsets; ++s) pbits[s * 2] = pbits[s * 2 + 1] = (int)bits.read(1);
+        }
+        for (int e = 0; e < endpointCount; ++e) {
+            for (int c = 0; c < 3; ++c) endpoints[e][c] = (endpoints[e][c] << 1) | pbits[e];
+            if (mode.alphaBits) endpoints[e][3] = (endpoints[e][3] << 1) | pbits[e];
+        }
+        colorBits++;
+        if (mode.alphaBits) alphaBits++;
+    }
+
+    // Expand to 8 bits by replicating the high bits
+    for (int e = 0; e < endpointCount; ++e) {
+        for (int c = 0; c < 3; ++c) {
+            endpoints[e][c] = (endpoints[e][c] << (8 - colorBits)) | (endpoints[e][c] >> (2 * colorBits - 8));
+        }
+        if (mode.alphaBits && alphaBits < 8) {
+            endpoints[e][3] = (endpoints[e][3] << (8 - alphaBits)) | (endpoints[e][3] >> (2 * alphaBits - 8));
+        }
+    }
+
+    int primary[16], secondary[16] = {};
+    for (int i = 0; i < 16; ++i) {
+        bool anchor = Bc7IsAnchor(mode.subsets, partition, i);
+        primary[i] = (int)bits.read(mode.indexBits - (anchor ? 1 : 0));
+    }
+    if (mode.secondaryIndexBits) {
+        for (int i = 0; i < 16; ++i) secondary[i] = (int)bits.read(mode.secondaryIndexBits - (i == 0 ? 1 : 0));
+    }
+
+    for (int i = 0; i < 16; ++i) {
+        int subset = Bc7Subset(mode.subsets, partition, i);
+        const int* e0 = endpoints[subset * 2];
+        const int* e1 = endpoints[subset * 2 + 1];
+        int colorWeight, alphaWeight;
+        if (mode.secondaryIndexBits == 0) {
+            colorWeight = alphaWeight = Bc7WeightTable(mode.indexBits)[primary[i]];
+        } else if (indexSelection == 0) {
+            colorWeight = Bc7WeightTable(mode.indexBits)[primary[i]];
+            alphaWeight = Bc7WeightTable(mode.secondaryIndexBits)[secondary[i]];
+        } else {
+            colorWeight = Bc7WeightTable(mode.secondaryIndexBits)[secondary[i]];
+            alphaWeight = Bc7WeightTable(mode.indexBits)[primary[i]];
+        }
+
+        uint8_t* out = rgba + i * 4;
+        for (int c = 0; c < 3; ++c) out[c] = (uint8_t)Bc7Interpolate(e0[c], e1[c], colorWeight);
+        out[3] = (uint8_t)Bc7Interpolate(e0[3], e1[3], alphaWeight);
+        if (rotation > 0) std::swap(out[3], out[rotation - 1]);
+    }
+}
+
+// Mode 6 block: RGBA endpoints of 7 bits plus a p-bit each, 16-level indices
+inline void EncodeBc7Block(const uint8_t rgba[64], uint8_t out[16]) {
+    float points[16 * 4];
+    for (int i = 0; i < 64; ++i) points[i] = rgba[i];
+
+    // Quantize an endpoint to 7 bits + p-bit, picking the p-bit with the smaller error
+    auto quantize = [](const float* e, int* q, int* pbit) {
+        float bestError = 1e30f;
+        for (int p = 0; p < 2; ++p) {
+            float error = 0.0f;
+            int candidate[4];
+            for (int c = 0; c < 4; ++c) {
+                int v = (int)std::lround((e[c] - p) / 2.0f);
+                candidate[c] = std::min(std::max(v, 0), 127);
+                float diff = (float)((candidate[c] << 1) | p) - e[c];
+                error += diff * diff;
+            }
+            if (error < bestError) {
+                bestError = error;
+                *pbit = p;
+                std::memcpy(q, candidate, sizeof(candidate));
+            }
+        }
+    };
+
+    auto encodeWith = [&](const float* e0, const float* e1, uint8_t block[16], int* indicesOut) {
+        int q0[4], q1[4], p0 = 0, p1 = 0;
+        quantize(e0, q0, &p0);
+        quantize(e1, q1, &p1);
+        int ends[2][4];
+        for (int c = 0; c < 4; ++c) {
+            ends[0][c] = (q0[c] << 1) | p0;
+            ends[1][c] = (q1[c] << 1) | p1;
+        }
+
+        int indices[16];
+        int error = 0;
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestDistance = 1 << 30;
+            for (int w = 0; w < 16; ++w) {
+                int d = 0;
+                for (int c = 0; c < 4; ++c) {
+                    int diff = Bc7Interpolate(ends[0][c], ends[1][c], Bc7Weights4[w]) - rgba[i * 4 + c];
+                    d += diff * diff;
+                }
+                if (d < bestDistance) {
+                    bestDistance = d;
+                    best = w;
+                }
+            }
+            indices[i] = best;
+            error += bestDistance;
+        }
+
+        // The anchor (pixel 0) index is stored without its top bit: swap the ends if it is set
+        if (indices[0] & 8) {
+            for (int c = 0; c < 4; ++c) std::swap(q0[c], q1[c]);
+            std::swap(p0, p1);
+            for (int i = 0; i < 16; ++i) indices[i] = 15 - indices[i];
+        }
+
+        std::memset(block, 0, 16);
+        BlockBits bits(block);
+        bits.write(1 << 6, 7); // mode 6
+        for (int c = 0; c < 4; ++c) {
+            bits.write((uint32_t)q0[c], 7);
+            bits.write((uint32_t)q1[c], 7);
+        }
+        bits.write((uint32_t)p0, 1);
+        bits.write((uint32_t)p1, 1);
+        for (int i = 0; i < 16; ++i) bits.write((uint32_t)indices[i], i == 0 ? 3 : 4);
+        if (indicesOut) std::memcpy(indicesOut, indices, sizeof(indices));
+        return error;
+    };
+
+    float e0[4], e1[4];
+    FitEndpoints(points, 16, 4, e0, e1);
+    int indices[16];
+    int bestError = encodeWith(e0, e1, out, indices);
+
+    // Least-squares refinement on the chosen indices (relative to the stored endpoint order)
+    for (int iteration = 0; iteration < 2 && bestError > 0; ++iteration) {
+        float t[16];
+        for (int i = 0; i < 16; ++i) t[i] = Bc7Weights4[indices[i]] / 64.0f;
+        float r0[4], r1[4];
+        if (!RefineEndpoints(points, t, 16, 4, r0, r1)) break;
+        uint8_t candidate[16];
+        int candidateIndices[16];
+        int error = encodeWith(r0, r1, candidate, candidateIndices);
+        if (error >= bestError) break;
+        bestError = error;
+        std::memcpy(out, candidate, 16);
+        std::memcpy(indices, candidateIndices, sizeof(indices));
+    }
+}
+
+// ---------------------------------------------------------------------------------------------
+// Whole images
+// ---------------------------------------------------------------------------------------------
+
+// Compress one level of tightly packed 'channels' pixels
+inline std::vector<uint8_t> EncodeLevel(BlockFormat format, const uint8_t* pixels, int width, int height, int channels) {
+    std::vector<uint8_t> out(LevelBytes(format, width, height));
+    const int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    const size_t blockBytes = BlockBytes(format);
+    uint8_t rgba[64];
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            FetchBlock(pixels, width, height, channels, bx, by, rgba);
+            uint8_t* block = out.data() + ((size_t)by * blocksX + bx) * blockBytes;
+            if (format == BlockFormat::BC1) {
+                EncodeColorBlock(rgba, block);
+            } else if (format == BlockFormat::BC3) {
+                EncodeAlphaBlock(rgba, block);
+                EncodeColorBlock(rgba, block + 8);
+            } else {
+                EncodeBc7Block(rgba, block);
+            }
+        }
+    }
+    return out;
+}
+
+// Decompress one level to tightly packed RGBA
+inline std::vector<uint8_t> DecodeLevel(BlockFormat format, const uint8_t* data, int width, int height) {
+    std::vector<uint8_t> out((size_t)width * height * 4);
+    const int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    const size_t blockBytes = BlockBytes(format);
+    uint8_t rgba[64];
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            const uint8_t* block = data + ((size_t)by * blocksX + bx) * blockBytes;
+            if (format == BlockFormat::BC1) {
+                DecodeColorBlock(block, true, rgba);
+            } else if (format == BlockFormat::BC3) {
+                DecodeColorBlock(block + 8, false, rgba);
+                DecodeAlphaBlock(block, rgba);
+            } else {
+                DecodeBc7Block(block, rgba);
+            }
+            for (int y = 0; y < 4 && by * 4 + y < height; ++y) {
+                for (int x = 0; x < 4 && bx * 4 + x < width; ++x) {
+                    std::memcpy(&out[(((size_t)by * 4 + y) * width + bx * 4 + x) * 4], rgba + (y * 4 + x) * 4, 4);
+                }
+            }
+        }
+    }
+    return out;
+}
+
+// Replace the raw pixels and mips of 'image' with 'format' blocks
+inline void Compress(ImageData& image, BlockFormat format) {
+    if (format == BlockFormat::None || image.block != BlockFormat::None || !image.valid()) return;
+    image.pixels = EncodeLevel(format, image.pixels.data(), image.width, image.height, image.channels);
+    for (size_t level = 1; level <= image.mips.size(); ++level) {
+        std::vector<uint8_t>& mip = image.mips[level - 1];
+        mip = EncodeLevel(format, mip.data(), ImageData::MipSize(image.width, (int)level),
+                          ImageData::MipSize(image.height, (int)level), image.channels);
+    }
+    image.channels = 4;
+    image.block = format;
+}
+
+// Transcode a block-compressed image back to RGBA (for drivers without the extension)
+inline void Decompress(ImageData& image) {
+    if (image.block == BlockFormat::None) return;
+    image.pixels = DecodeLevel(image.block, image.pixels.data(), image.width, image.height);
+    for (size_t level = 1; level <= image.mips.size(); ++level) {
+        std::vector<uint8_t>& mip = image.mips[level - 1];
+        mip = DecodeLevel(image.block, mip.data(), ImageData::MipSize(image.width, (int)level),
+                          ImageData::MipSize(image.height, (int)level));
+    }
+    image.channels = 4;
+    image.block = BlockFormat::None;
+}
+
+// True if any pixel is not fully opaque
+inline bool HasAlpha(const ImageData& image) {
+    if (image.channels != 2 && image.channels != 4) return false;
+    for (size_t i = image.channels - 1; i < image.pixels.size(); i += image.channels) {
+        if (image.pixels[i] != 255) return true;
+    }
+    return false;
+}
+
+} // namespace BlockCompression
+
+#endif
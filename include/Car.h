@@ -2,22 +2,25 @@
 #define CAR_H
 
 #include "GameObject.h"
-#include "Model.h"
+#include "ModelCache.h"
 #include <glad/glad.h>
 #include <cstdlib>
 #include <ctime>
 
 class Car : public GameObject {
 public:
+    // Shared by every car; main() keeps a handle alive so despawning all cars doesn't unload it
+    static constexpr const char* ModelPath = "assets/models/free-retro-american-car-cartoon-low-poly/source/RetroCar/RetroCar.obj";
+
     int lane;
     float laneWidth;
-    Model* model;
+    ModelHandle model;
     bool useModel;
+    unsigned int textureVariant; // which of the model's diffuse maps this car wears (see Mesh::Draw)
 
     Car(int laneNumber, float width, bool movingRight) {
         lane = laneNumber;
         laneWidth = width;
-        model = nullptr;
         useModel = false;
         
         // Position based on lane (lanes are in Z axis)
@@ -43,32 +46,23 @@ public:
         float g = 0.3f + static_cast<float>(rand()) / RAND_MAX * 0.7f;
         float b = 0.3f + static_cast<float>(rand()) / RAND_MAX * 0.7f;
         color = glm::vec3(r, g, b);
+        textureVariant = (unsigned int)rand();
 
     // Try to load model (new assets path under assets/models)
-    LoadModel("assets/models/free-retro-american-car-cartoon-low-poly/source/RetroCar/RetroCar.obj");
+    LoadModel(ModelPath);
         
         // Fallback to cube if model not found
         if (!useModel) {
-            scale = glm::vec3(4.0f, 1.2f, 2.0f); // Box car size (ยาวแนวนอน - ใหญ่ขึ้น)
-            CreateCarMesh();
-        }
-    }
-
-    ~Car() {
-        if (model != nullptr) {
-            delete model;
+            UseFallbackMesh();
         }
     }
 
     void LoadModel(const std::string& path) {
-        model = new Model();
-        useModel = model->loadModel(path);
-        if (useModel) {
-            // std::cout << "Car model loaded from: " << path << std::endl;
-        } else {
+        // All cars share one imported model through the cache
+        model = ModelCache::Instance().Acquire(path);
+        useModel = (model != nullptr);
+        if (!useModel) {
             std::cout << "Could not load car model, using fallback cube" << std::endl;
-            delete model;
-            model = nullptr;
         }
     }
 
@@ -84,15 +78,36 @@ public:
         }
     }
 
+    // True when the shared model is ready, so the car can be batched by CarRenderer
+    bool UsesSharedModel() {
+        checkModelFailed();
+        return useModel && model->loaded;
+    }
+
     void Draw() override {
-        if (useModel && model != nullptr) {
-            model->Draw();
+        checkModelFailed();
+
+        if (useModel) {
+            if (model->loaded) model->Draw(GetModelMatrix(), lodLevel, textureVariant); // nothing to draw while still pending
         } else {
             GameObject::Draw();
         }
     }
 
 private:
+    // The model may still be streaming in; switch to the box once it is known to have failed
+    void checkModelFailed() {
+        if (useModel && !model->loaded && !model->isPending()) {
+            useModel = false;
+            UseFallbackMesh();
+        }
+    }
+
+    void UseFallbackMesh() {
+        scale = glm::vec3(4.0f, 1.2f, 2.0f); // Box car size (ยาวแนวนอน - ใหญ่ขึ้น)
+        CreateCarMesh();
+    }
+
     void CreateCarMesh() {
         // Simple box car mesh
         vertices = {
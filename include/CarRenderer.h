@@ -0,0 +1,88 @@
+#ifndef CAR_RENDERER_H
+#define CAR_RENDERER_H
+
+#include "Car.h"
+#include "Model.h"
+#include "Shader.h"
+#include "RenderQueue.h"
+#include <glad/glad.h>
+#include <vector>
+
+// Draws every car that uses the shared car model with one glDrawElementsInstanced call per
+// mesh, LOD level and texture variant, so the draw-call count stays the same however much
+// traffic there is.
+// Each frame: Begin(), Submit() every car (cars it rejects are queued as objects), Flush()
+// to upload the instances and queue the instanced draws.
+class CarRenderer {
+public:
+    CarRenderer() {
+        glGenBuffers(1, &instanceVBO);
+    }
+
+    ~CarRenderer() {
+        if (instanceVBO != 0) glDeleteBuffers(1, &instanceVBO);
+    }
+
+    CarRenderer(const CarRenderer&) = delete;
+    CarRenderer& operator=(const CarRenderer&) = delete;
+
+    void Begin() {
+        for (auto& batch : batches) batch.clear();
+        model.reset();
+        variants = 1;
+    }
+
+    // Queue 'car' for the instanced draw unless it is outside the view frustum. Returns false
+    // if it has no shared model to batch (still loading or using the fallback box); the caller
+    // queues it as a plain object.
+    bool Submit(Car& car, const RenderQueue& queue) {
+        if (!car.UsesSharedModel()) return false;
+
+        glm::mat4 modelMatrix = car.GetModelMatrix();
+        if (!queue.Visible(modelMatrix, *car.model)) return true;
+        car.lodLevel = car.model->selectLod(modelMatrix, car.lodLevel);
+        model = car.model; // every car acquires the same model through ModelCache
+        variants = model->diffuseVariants;
+        batches.resize(std::max(batches.size(), (size_t)(MaxLodLevels * variants)));
+        int lod = std::min(std::max(car.lodLevel, 0), MaxLodLevels - 1);
+        batches[lod * variants + car.textureVariant % variants].push_back({ modelMatrix, glm::vec4(car.color, 1.0f), NormalMatrix(modelMatrix) });
+        return true;
+    }
+
+    // Upload all queued instances and add their draws to 'queue'
+    void Flush(RenderQueue& queue, Shader& shader) {
+        if (!model) return;
+
+        size_t total = 0;
+        for (const auto& batch : batches) total += batch.size();
+        if (total == 0) return;
+
+        // Orphan the old storage each frame so the driver doesn't stall on last frame's draws
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        capacity = std::max(capacity, total);
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+        size_t offset = 0;
+        for (const auto& batch : batches) {
+            glBufferSubData(GL_ARRAY_BUFFER, offset * sizeof(InstanceData), batch.size() * sizeof(InstanceData), batch.data());
+            offset += batch.size();
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        size_t first = 0;
+        for (size_t i = 0; i < batches.size(); ++i) {
+            queue.SubmitInstanced(shader, *model, (int)(i / variants), (unsigned int)(i % variants), instanceVBO, first,
+                                  (GLsizei)batches[i].size());
+            first += batches[i].size();
+        }
+    }
+
+private:
+    GLuint instanceVBO = 0;
+    size_t capacity = 0; // instances the buffer was last sized for
+    std::vector<std::vector<InstanceData>> batches; // queued instances, by LOD level then texture variant
+    unsigned int variants = 1; // texture variants of 'model'
+    ModelHandle model;
+};
+
+#endif
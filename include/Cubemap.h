@@ -8,50 +8,65 @@
 #include <string>
 #include <iostream>
 #include <vector>
-#include <windows.h>
-#include <gdiplus.h>
+#include "TextureCache.h"
+#include "RenderState.h"
+#include "BakedTexture.h"
+#include "AssetLoader.h"
+#include <memory>
+#include <mutex>
 
 class Cubemap {
 public:
+    static constexpr GLsizei VertexCount = 36;
+
     unsigned int textureID;
     unsigned int VAO, VBO;
+    TextureHandle texture; // owns textureID (shared through TextureCache)
 
     Cubemap() : textureID(0), VAO(0), VBO(0) {}
 
     ~Cubemap() {
         if (VAO != 0) glDeleteVertexArrays(1, &VAO);
         if (VBO != 0) glDeleteBuffers(1, &VBO);
-        if (textureID != 0) glDeleteTextures(1, &textureID);
     }
 
-    bool LoadCubemap(const std::string& posX, const std::string& negX,
-                     const std::string& posY, const std::string& negY,
-                     const std::string& posZ, const std::string& negZ) {
-        glGenTextures(1, &textureID);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
-
-        std::vector<std::string> faces = { posX, negX, posY, negY, posZ, negZ };
-        GLenum targets[6] = {
-            GL_TEXTURE_CUBE_MAP_POSITIVE_X, GL_TEXTURE_CUBE_MAP_NEGATIVE_X,
-            GL_TEXTURE_CUBE_MAP_POSITIVE_Y, GL_TEXTURE_CUBE_MAP_NEGATIVE_Y,
-            GL_TEXTURE_CUBE_MAP_POSITIVE_Z, GL_TEXTURE_CUBE_MAP_NEGATIVE_Z
+    // Load the cube map (faces +X, -X, +Y, -Y, +Z, -Z). The six faces are decoded concurrently
+    // on 'loader' (one job per face) and uploaded together on the main thread once the last one
+    // finishes. textureID stays 0 (skybox not drawn) until then.
+    void LoadCubemapAsync(AssetLoader& loader,
+                          const std::string& posX, const std::string& negX,
+                          const std::string& posY, const std::string& negY,
+                          const std::string& posZ, const std::string& negZ) {
+        struct PendingFaces {
+            std::vector<std::string> paths;
+            DecodedImages images;
+            std::mutex mutex;
+            size_t remaining = 0;
         };
-
-        for (unsigned int i = 0; i < faces.size(); ++i) {
-            if (!LoadCubemapFace(targets[i], faces[i])) {
-                std::cerr << "Failed to load cubemap face: " << faces[i] << std::endl;
-                return false;
-            }
+        auto pending = std::make_shared<PendingFaces>();
+        pending->paths = { posX, negX, posY, negY, posZ, negZ };
+        pending->remaining = pending->paths.size();
+        std::string key = TextureCache::CubemapKey(pending->paths);
+
+        for (const auto& face : pending->paths) {
+            loader.Enqueue([this, face, key, pending]() -> AssetLoader::UploadStep {
+                // Faces of a cached cubemap are not decoded; the upload just takes the handle
+                bool cached = TextureCache::Instance().Contains(key);
+                ImageData image;
+                if (!cached && !DecodeCubemapFace(face, image)) image = ImageData();
+
+                std::lock_guard<std::mutex> lock(pending->mutex);
+                if (!cached) pending->images[face] = std::move(image);
+                if (--pending->remaining > 0) return nullptr; // the last face uploads all six
+
+                return [this, pending]() {
+                    texture = TextureCache::Instance().AcquireCubemap(pending->paths,
+                                                                      TextureCache::FromDecoded(pending->images, DecodeCubemapFace));
+                    textureID = texture ? texture->id : 0;
+                    if (texture) std::cout << "Cubemap loaded successfully!" << std::endl;
+                };
+            });
         }
-
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-
-        std::cout << "Cubemap loaded successfully!" << std::endl;
-        return true;
     }
 
     void SetupMesh() {
@@ -104,7 +119,7 @@ public:
         glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
 
-        glBindVertexArray(VAO);
+        RenderState::Instance().BindVertexArray(VAO);
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
         glBufferData(GL_ARRAY_BUFFER, sizeof(skyboxVertices), skyboxVertices, GL_STATIC_DRAW);
 
@@ -112,77 +127,14 @@ public:
         glEnableVertexAttribArray(0);
 
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-    }
-
-    void Draw() {
-        glBindVertexArray(VAO);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
-        glBindVertexArray(0);
+        RenderState::Instance().BindVertexArray(0);
     }
 
 private:
-    bool LoadCubemapFace(GLenum target, const std::string& path) {
-        using namespace Gdiplus;
-
-        // Convert char* to wchar_t*
-        int len = path.length();
-        wchar_t* widePath = new wchar_t[len + 1];
-        mbstowcs(widePath, path.c_str(), len + 1);
-
-        Image* image = new Image(widePath);
-        delete[] widePath;
-
-        if (image->GetLastStatus() != Ok || image->GetWidth() == 0 || image->GetHeight() == 0) {
-            std::cerr << "Warning: Failed to load image: " << path << std::endl;
-            delete image;
-            return false;
-        }
-
-        UINT width = image->GetWidth();
-        UINT height = image->GetHeight();
-
-        // Create an RGBA bitmap
-        Bitmap* bitmap = new Bitmap(width, height, PixelFormat32bppARGB);
-        Graphics* graphics = Graphics::FromImage(bitmap);
-        graphics->DrawImage(image, 0, 0);
-        delete graphics;
-
-        // Lock bitmap bits for reading
-        BitmapData bitmapData;
-        Rect rect(0, 0, width, height);
-        bitmap->LockBits(&rect, ImageLockModeRead, PixelFormat32bppARGB, &bitmapData);
-
-        unsigned char* pixels = static_cast<unsigned char*>(bitmapData.Scan0);
-        unsigned char* textureData = new unsigned char[width * height * 4];
-
-        // Copy and convert BGRA -> RGBA
-        for (UINT y = 0; y < height; ++y) {
-            for (UINT x = 0; x < width; ++x) {
-                int src_idx = (y * bitmapData.Stride) + (x * 4);
-                int dst_idx = (y * width + x) * 4;
-                // BGRA -> RGBA
-                textureData[dst_idx + 0] = pixels[src_idx + 2]; // R
-                textureData[dst_idx + 1] = pixels[src_idx + 1]; // G
-                textureData[dst_idx + 2] = pixels[src_idx + 0]; // B
-                textureData[dst_idx + 3] = pixels[src_idx + 3]; // A
-            }
-        }
-
-        bitmap->UnlockBits(&bitmapData);
-
-        // Upload to OpenGL
-        glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
-        glTexImage2D(target, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, textureData);
-
-        delete[] textureData;
-        delete bitmap;
-        delete image;
-
-        std::cout << "Loaded cubemap face: " << path << " (" << width << "x" << height << ")" << std::endl;
-
+    // Decode one face; the upload happens in TextureCache
+    static bool DecodeCubemapFace(const std::string& path, ImageData& out) {
+        if (!BakedTexture::Decode(path, out)) return false;
+        std::cout << "Loaded cubemap face: " << path << " (" << out.width << "x" << out.height << ")" << std::endl;
         return true;
     }
 };
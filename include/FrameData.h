@@ -0,0 +1,72 @@
+#ifndef FRAME_DATA_H
+#define FRAME_DATA_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+
+// Camera, lighting and fog state shared by every shader through one std140 uniform block.
+// Shaders declare the matching block (copy it verbatim):
+//
+//   layout (std140) uniform FrameData {
+//       mat4 view;
+//       mat4 projection;
+//       mat4 screenProjection; // pixels, origin top-left (text and HUD)
+//       vec3 lightPos;   float fogNear;
+//       vec3 lightColor; float fogFar;
+//       vec3 viewPos;
+//       vec3 fogColor;
+//   };
+//
+// Shader binds any block named FrameData to FrameData::Binding after linking, so a new
+// shader only has to declare it.
+struct FrameData {
+    static constexpr GLuint Binding = 0;
+    static constexpr const char* BlockName = "FrameData";
+
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 screenProjection;
+    glm::vec3 lightPos;
+    float fogNear;
+    glm::vec3 lightColor;
+    float fogFar;
+    glm::vec3 viewPos;
+    float pad0; // std140: each vec3 starts a new 16-byte slot
+    glm::vec3 fogColor;
+    float pad1;
+};
+
+static_assert(offsetof(FrameData, lightPos) == 192 && offsetof(FrameData, fogNear) == 204, "FrameData must match std140");
+static_assert(offsetof(FrameData, viewPos) == 224 && offsetof(FrameData, fogColor) == 240, "FrameData must match std140");
+static_assert(sizeof(FrameData) == 256, "FrameData must match std140");
+
+// The uniform buffer behind the FrameData block, updated with one upload per frame
+class FrameDataBuffer {
+public:
+    FrameDataBuffer() {
+        glGenBuffers(1, &UBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, FrameData::Binding, UBO);
+    }
+
+    ~FrameDataBuffer() {
+        if (UBO != 0) glDeleteBuffers(1, &UBO);
+    }
+
+    FrameDataBuffer(const FrameDataBuffer&) = delete;
+    FrameDataBuffer& operator=(const FrameDataBuffer&) = delete;
+
+    void Update(const FrameData& data) {
+        glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &data);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+private:
+    GLuint UBO = 0;
+};
+
+#endif
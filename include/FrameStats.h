@@ -0,0 +1,150 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include "MeshData.h"
+
+#include <string>
+#include <cstdint>
+
+// Parts of the frame whose fragments RenderQueue counts with occlusion queries
+enum class FragmentPass {
+    DepthPrepass,
+    Opaque,
+    Ground,
+    Sky,
+    Count,
+};
+
+// Per-frame rendering counters, reset by the game loop at the start of every frame and shown
+// in the debug overlay (F3)
+class FrameStats {
+public:
+    static FrameStats& Instance() {
+        static FrameStats instance;
+        return instance;
+    }
+
+    void BeginFrame() {
+        for (int level = 0; level < MaxLodLevels; ++level) {
+            lodTriangles[level] = 0;
+            lodDraws[level] = 0;
+        }
+        uniformUploads = 0;
+        uniformSkips = 0;
+        stateChanges = 0;
+        stateSkips = 0;
+        objectsVisible = 0;
+        objectsCulled = 0;
+        // Text is drawn after the overlay is queued, so the overlay shows the previous frame's
+        lastTextDraws = textDraws;
+        lastTextGlyphs = textGlyphs;
+        lastGlyphsRasterized = glyphsRasterized;
+        lastGlyphEvictions = glyphEvictions;
+        textDraws = 0;
+        textGlyphs = 0;
+        glyphsRasterized = 0;
+        glyphEvictions = 0;
+    }
+
+    void RecordDraw(int lod, unsigned int triangles) {
+        if (lod < 0 || lod >= MaxLodLevels) return;
+        lodTriangles[lod] += triangles;
+        lodDraws[lod]++;
+    }
+
+    // A Shader::set* call: 'uploaded' is false when the value was unchanged and no GL call was made
+    void RecordUniformUpload(bool uploaded) {
+        if (uploaded) uniformUploads++;
+        else uniformSkips++;
+    }
+
+    unsigned int UniformUploads() const { return uniformUploads; }
+    unsigned int UniformSkips() const { return uniformSkips; }
+
+    std::string UniformLine() const {
+        return "Uniforms: " + std::to_string(uniformUploads) + " uploaded, " + std::to_string(uniformSkips) + " skipped";
+    }
+
+    // A RenderState bind: 'issued' is false when the object was already bound
+    void RecordStateChange(bool issued) {
+        if (issued) stateChanges++;
+        else stateSkips++;
+    }
+
+    std::string StateLine() const {
+        return "Binds: " + std::to_string(stateChanges) + " issued, " + std::to_string(stateSkips) + " filtered";
+    }
+
+    // An object tested against the view frustum
+    void RecordCulling(bool visible) {
+        if (visible) objectsVisible++;
+        else objectsCulled++;
+    }
+
+    std::string CullingLine() const {
+        return "Objects: " + std::to_string(objectsVisible) + " visible, " + std::to_string(objectsCulled) + " culled";
+    }
+
+    // A TextRenderer batch of 'glyphs' quads drawn with one call
+    void RecordTextDraw(unsigned int glyphs) {
+        textDraws++;
+        textGlyphs += glyphs;
+    }
+
+    // GlyphCache: a glyph run through FreeType, and a glyph that gave up its atlas cell
+    void RecordGlyphRasterized() { glyphsRasterized++; }
+    void RecordGlyphEviction() { glyphEvictions++; }
+
+    // Samples of 'pass' that passed the depth test, from a GL_SAMPLES_PASSED query a few frames
+    // old. Kept until the next result arrives rather than reset every frame.
+    void RecordFragments(FragmentPass pass, uint64_t samples) { fragments[(int)pass] = samples; }
+
+    std::string FragmentLine() const {
+        return "Fragments: prepass " + std::to_string(fragments[(int)FragmentPass::DepthPrepass]) +
+               ", opaque " + std::to_string(fragments[(int)FragmentPass::Opaque]) +
+               ", ground " + std::to_string(fragments[(int)FragmentPass::Ground]) +
+               ", sky " + std::to_string(fragments[(int)FragmentPass::Sky]);
+    }
+
+    std::string TextLine() const {
+        return "Text: " + std::to_string(lastTextDraws) + " draws, " + std::to_string(lastTextGlyphs) + " glyphs, " +
+               std::to_string(lastGlyphsRasterized) + " rasterized, " + std::to_string(lastGlyphEvictions) + " evicted";
+    }
+
+    unsigned int LodTriangles(int lod) const { return lodTriangles[lod]; }
+    unsigned int LodDraws(int lod) const { return lodDraws[lod]; }
+
+    unsigned int TotalTriangles() const {
+        unsigned int total = 0;
+        for (int level = 0; level < MaxLodLevels; ++level) total += lodTriangles[level];
+        return total;
+    }
+
+    std::string LodLine(int lod) const {
+        return "LOD" + std::to_string(lod) + ": " + std::to_string(lodTriangles[lod]) + " tris, " +
+               std::to_string(lodDraws[lod]) + " draws";
+    }
+
+private:
+    FrameStats() : textDraws(0), textGlyphs(0), glyphsRasterized(0), glyphEvictions(0) { BeginFrame(); }
+
+    unsigned int lodTriangles[MaxLodLevels];
+    unsigned int lodDraws[MaxLodLevels];
+    unsigned int uniformUploads;
+    unsigned int uniformSkips;
+    unsigned int stateChanges;
+    unsigned int stateSkips;
+    unsigned int objectsVisible;
+    unsigned int objectsCulled;
+    unsigned int textDraws;
+    unsigned int textGlyphs;
+    unsigned int lastTextDraws;
+    unsigned int lastTextGlyphs;
+    unsigned int glyphsRasterized;
+    unsigned int glyphEvictions;
+    unsigned int lastGlyphsRasterized;
+    unsigned int lastGlyphEvictions;
+    uint64_t fragments[(int)FragmentPass::Count] = {};
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+#include <cmath>
+#include <algorithm>
+
+// View frustum as six inward-facing planes (a, b, c, d: a*x + b*y + c*z + d >= 0 inside),
+// extracted from a projection * view matrix (Gribb/Hartmann). Tests are conservative: an
+// object reported invisible is entirely outside one plane.
+class Frustum {
+public:
+    Frustum() = default;
+
+    explicit Frustum(const glm::mat4& viewProjection) {
+        // Rows of the matrix (glm is column-major: m[column][row])
+        glm::vec4 rows[4];
+        for (int r = 0; r < 4; ++r) {
+            rows[r] = glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+        }
+        planes[0] = rows[3] + rows[0]; // left
+        planes[1] = rows[3] - rows[0]; // right
+        planes[2] = rows[3] + rows[1]; // bottom
+        planes[3] = rows[3] - rows[1]; // top
+        planes[4] = rows[3] + rows[2]; // near
+        planes[5] = rows[3] - rows[2]; // far
+        for (glm::vec4& plane : planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+    }
+
+    bool IntersectsSphere(const glm::vec3& center, float radius) const {
+        for (const glm::vec4& plane : planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+        }
+        return true;
+    }
+
+    // World-space box given by 'center' and half-extents 'extents'
+    bool IntersectsBox(const glm::vec3& center, const glm::vec3& extents) const {
+        for (const glm::vec4& plane : planes) {
+            glm::vec3 normal = glm::vec3(plane);
+            float reach = glm::dot(extents, glm::abs(normal)); // projected half-size on the normal
+            if (glm::dot(normal, center) + plane.w < -reach) return false;
+        }
+        return true;
+    }
+
+    // Model-space bounds ('aabbMin'..'aabbMax' and a sphere around the box centre) placed with
+    // 'matrix'. The cheap sphere test rejects most objects; survivors are tested with the
+    // transformed box, which is tighter for long thin shapes.
+    bool IntersectsBounds(const glm::mat4& matrix, const glm::vec3& aabbMin, const glm::vec3& aabbMax, float radius) const {
+        glm::vec3 localCenter = (aabbMin + aabbMax) * 0.5f;
+        glm::vec3 center = glm::vec3(matrix * glm::vec4(localCenter, 1.0f));
+        float scale = std::sqrt(std::max(glm::dot(glm::vec3(matrix[0]), glm::vec3(matrix[0])),
+                                std::max(glm::dot(glm::vec3(matrix[1]), glm::vec3(matrix[1])),
+                                         glm::dot(glm::vec3(matrix[2]), glm::vec3(matrix[2])))));
+        if (!IntersectsSphere(center, radius * scale)) return false;
+
+        // World extents of the transformed box (Arvo): |M| * local extents
+        glm::vec3 localExtents = (aabbMax - aabbMin) * 0.5f;
+        glm::vec3 extents(0.0f);
+        for (int axis = 0; axis < 3; ++axis) {
+            extents += glm::abs(glm::vec3(matrix[axis])) * localExtents[axis];
+        }
+        return IntersectsBox(center, extents);
+    }
+
+private:
+    glm::vec4 planes[6] = {};
+};
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include "RenderState.h"
 #include <vector>
 
 class GameObject {
@@ -16,6 +17,7 @@ public:
     unsigned int VAO, VBO;
     std::vector<float> vertices;
     bool isActive;
+    int lodLevel; // level of detail last used to draw this object's model (for LOD hysteresis)
 
     GameObject() {
         position = glm::vec3(0.0f);
@@ -24,6 +26,7 @@ public:
         color = glm::vec3(1.0f);
         velocity = glm::vec3(0.0f);
         isActive = true;
+        lodLevel = 0;
         VAO = 0;
         VBO = 0;
     }
@@ -52,9 +55,8 @@ public:
             CreateDefaultQuad(); // Lazy initialization - create simple 2D quad
         }
         if (VAO != 0) {
-            glBindVertexArray(VAO);
+            RenderState::Instance().BindVertexArray(VAO);
             glDrawArrays(GL_TRIANGLES, 0, vertices.size() / 3);
-            glBindVertexArray(0);
         }
     }
 
@@ -77,7 +79,7 @@ public:
         glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
 
-        glBindVertexArray(VAO);
+        RenderState::Instance().BindVertexArray(VAO);
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
         glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
 
@@ -86,7 +88,7 @@ public:
         glEnableVertexAttribArray(0);
 
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+        RenderState::Instance().BindVertexArray(0);
     }
 
     // Simple AABB collision detection (touching the car counts as collision)
@@ -117,7 +119,7 @@ protected:
         glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
 
-        glBindVertexArray(VAO);
+        RenderState::Instance().BindVertexArray(VAO);
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
         glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), &vertices[0], GL_STATIC_DRAW);
 
@@ -125,7 +127,7 @@ protected:
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
         glEnableVertexAttribArray(0);
 
-        glBindVertexArray(0);
+        RenderState::Instance().BindVertexArray(0);
     }
 };
 
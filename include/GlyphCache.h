@@ -0,0 +1,410 @@
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include "RenderState.h"
+#include "FrameStats.h"
+#include "SdfGenerator.h"
+#include "BakedFont.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+
+// A glyph's place in the atlas texture plus its metrics, in pixels at
+// GlyphCache::NominalPixelSize (text drawn with scale 1)
+struct Character {
+    glm::vec2 UVMin;   // atlas texture coordinates of the bitmap's top-left corner
+    glm::vec2 UVMax;   // ... and bottom-right corner
+    glm::vec2 Size;
+    glm::vec2 Bearing;
+    float     Advance;
+};
+
+// How glyphs are stored in the atlas
+enum class GlyphMode {
+    Bitmap, // coverage rasterized at NominalPixelSize; blurry when scaled up
+    Sdf,    // signed distance field: one small set that stays sharp at every scale
+};
+
+// The glyphs TextRenderer draws, rasterized on first use into a fixed-size atlas texture.
+//
+// The atlas is a grid of equal cells, each big enough for one glyph of the tallest font. A
+// glyph takes a cell the first time Acquire() sees it; when every cell is taken, the least
+// recently used glyph gives its cell up. Glyphs used in the current frame are never evicted,
+// since queued quads still point at them: if one frame needs more glyphs than there are cells,
+// the extra ones are skipped for that frame. Pinned glyphs (those of live TextLabels) keep
+// their cells until unpinned, so retained quads stay valid without being touched each frame. Memory is therefore fixed by AtlasSize whatever
+// text the game shows, and nothing is rasterized at startup.
+//
+// Fonts: the first primary font found, plus every fallback found for scripts it lacks (Thai).
+// Glyphs are keyed by face and FreeType glyph index, not codepoint, so shaped text (ligatures,
+// repositioned marks) caches like anything else.
+//
+// In SDF mode each font also keeps the fields it generated in memory, capped at the cell
+// count, and writes them to a BakedFont file on exit; the next session loads that instead of
+// running FreeType and the distance transform again.
+class GlyphCache {
+public:
+    static constexpr int AtlasSize = 1024;
+    static constexpr int GlyphPadding = 1;      // empty texels around each glyph so linear filtering doesn't bleed
+    static constexpr int NominalPixelSize = 48; // glyph height in pixels at scale 1 (what callers' scales assume)
+    static constexpr int SdfPixelSize = 32;     // size the distance fields are generated at
+    static constexpr int SdfSpread = 4;         // field range either side of the outline, in atlas texels
+    static constexpr int SdfSupersample = 4;    // glyphs are rasterized this much larger for the transform
+
+    explicit GlyphCache(GlyphMode mode) : mode(mode) {
+        if (FT_Init_FreeType(&ft)) {
+            std::cerr << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
+            ft = nullptr;
+            return;
+        }
+
+        // Load font - try multiple locations
+        std::vector<std::string> fontPaths = {
+            "C:/Windows/Fonts/arial.ttf",
+            "C:\\Windows\\Fonts\\arial.ttf",
+            "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf"
+        };
+        // Fonts with the Thai script, for codepoints the primary font lacks
+        std::vector<std::string> fallbackPaths = {
+            "C:/Windows/Fonts/tahoma.ttf",
+            "C:/Windows/Fonts/LeelawUI.ttf",
+            "/usr/share/fonts/truetype/tlwg/Garuda.ttf",
+            "/usr/share/fonts/truetype/noto/NotoSansThai-Regular.ttf"
+        };
+
+        for (const auto& fontPath : fontPaths) {
+            if (openFace(fontPath)) break;
+        }
+        if (faces.empty()) {
+            std::cerr << "ERROR::FREETYPE: Failed to load font from any location" << std::endl;
+            return;
+        }
+        for (const auto& fontPath : fallbackPaths) openFace(fontPath);
+
+        // One cell fits a line of the tallest face, plus the field margin
+        int tallest = 0;
+        for (const FontFace& face : faces) tallest = std::max(tallest, (int)((face.face->size->metrics.height + 63) >> 6));
+        int fieldHeight = mode == GlyphMode::Sdf ? (tallest + SdfSupersample - 1) / SdfSupersample + 2 * SdfSpread : tallest;
+        cellSize = fieldHeight + GlyphPadding;
+        cellsPerRow = AtlasSize / cellSize;
+        int cellCount = cellsPerRow * cellsPerRow;
+        freeCells.reserve(cellCount);
+        for (int cell = cellCount - 1; cell >= 0; --cell) freeCells.push_back(cell);
+        entries.reserve(cellCount);
+
+        glGenTextures(1, &atlasTexture);
+        RenderState::Instance().BindTexture(0, GL_TEXTURE_2D, atlasTexture);
+        std::vector<unsigned char> clear((size_t)AtlasSize * AtlasSize, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, AtlasSize, AtlasSize, 0, GL_RED, GL_UNSIGNED_BYTE, clear.data());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        RenderState::Instance().BindTexture(0, GL_TEXTURE_2D, 0);
+
+        std::cout << "Glyph atlas: " << AtlasSize << "x" << AtlasSize << (mode == GlyphMode::Sdf ? " SDF" : "")
+                  << ", " << cellCount << " cells of " << cellSize << "px, " << faces.size() << " font(s)" << std::endl;
+    }
+
+    ~GlyphCache() {
+        for (FontFace& face : faces) {
+            if (face.storeDirty) saveStore(face);
+            FT_Done_Face(face.face);
+        }
+        if (ft) FT_Done_FreeType(ft);
+        if (atlasTexture) glDeleteTextures(1, &atlasTexture);
+    }
+
+    GlyphCache(const GlyphCache&) = delete;
+    GlyphCache& operator=(const GlyphCache&) = delete;
+
+    bool Valid() const { return !faces.empty(); }
+    GLuint Texture() const { return atlasTexture; }
+    GlyphMode Mode() const { return mode; }
+
+    int FaceCount() const { return (int)faces.size(); }
+    FT_Face Face(int face) const { return faces[face].face; }
+
+    // Render-size 26.6 font units (FreeType and HarfBuzz positions) to nominal pixels
+    float FromFontUnits(FT_Pos value) const { return value / 64.0f * toNominal(); }
+
+    // The face to draw 'codepoint' with: 'preferred' if it has the glyph (keeps a mark in its
+    // base's font), otherwise the first face that does, otherwise the primary face (.notdef)
+    int FaceFor(char32_t codepoint, int preferred = -1) const {
+        if (preferred >= 0 && FT_Get_Char_Index(faces[preferred].face, codepoint) != 0) return preferred;
+        for (size_t i = 0; i < faces.size(); ++i) {
+            if (FT_Get_Char_Index(faces[i].face, codepoint) != 0) return (int)i;
+        }
+        return 0;
+    }
+
+    static uint32_t Key(int face, uint32_t glyphIndex) { return ((uint32_t)face << 24) | (glyphIndex & 0xFFFFFFu); }
+
+    // The atlas entry for glyph 'key', rasterizing it on a miss, and marks it used this frame.
+    // Returns nullptr if it can't be drawn this frame. The pointer stays valid until the next
+    // EndFrame(); a change of Generation() means earlier entries may have moved.
+    const Character* Acquire(uint32_t key) {
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            Entry& entry = it->second;
+            if (entry.cell >= 0 && entry.pins == 0) {
+                lru.splice(lru.begin(), lru, entry.lruPosition);
+                entry.lastFrame = frame;
+            }
+            return &entry.character;
+        }
+        return load(key);
+    }
+
+    // Keep glyph 'key' (already acquired) in its cell until a matching Unpin(); counted, so a
+    // glyph several labels use is pinned once per use
+    void Pin(uint32_t key) {
+        auto it = entries.find(key);
+        if (it == entries.end() || it->second.cell < 0) return;
+        Entry& entry = it->second;
+        if (entry.pins++ == 0) lru.erase(entry.lruPosition);
+    }
+
+    // Undo one Pin(); the glyph becomes evictable again once nothing pins it
+    void Unpin(uint32_t key) {
+        auto it = entries.find(key);
+        if (it == entries.end() || it->second.cell < 0) return;
+        Entry& entry = it->second;
+        if (--entry.pins == 0) {
+            lru.push_front(key);
+            entry.lruPosition = lru.begin();
+            entry.lastFrame = frame;
+        }
+    }
+
+    // Bumped whenever a glyph loses its cell
+    uint64_t Generation() const { return generation; }
+
+    // Called once per frame after the text is drawn; glyphs used so far become evictable
+    void EndFrame() { frame++; }
+
+private:
+    struct FontFace {
+        std::string path;
+        FT_Face face = nullptr;
+        // SDF mode: fields generated so far, by glyph index, and when each was last needed
+        std::unordered_map<uint32_t, BakedFont::Glyph> store;
+        std::unordered_map<uint32_t, uint64_t> storeUse;
+        bool storeDirty = false;
+    };
+
+    struct Entry {
+        Character character;
+        int cell = -1; // -1: nothing to draw (space), or didn't fit a cell
+        std::list<uint32_t>::iterator lruPosition; // only while unpinned
+        uint64_t lastFrame = 0;
+        int pins = 0;
+    };
+
+    GlyphMode mode;
+    FT_Library ft = nullptr;
+    std::vector<FontFace> faces;
+    GLuint atlasTexture = 0;
+    int cellSize = 0;
+    int cellsPerRow = 0;
+
+    std::unordered_map<uint32_t, Entry> entries;
+    std::list<uint32_t> lru; // keys of unpinned glyphs holding a cell, most recently used first
+    std::vector<int> freeCells;
+    std::vector<unsigned char> cellPixels; // upload scratch
+    uint64_t frame = 1;
+    uint64_t generation = 0;
+    uint64_t storeTick = 0;
+    bool warnedFull = false;
+
+    int renderSize() const { return mode == GlyphMode::Sdf ? SdfPixelSize * SdfSupersample : NominalPixelSize; }
+    float toNominal() const { return (float)NominalPixelSize / renderSize(); }
+
+    BakedFont::Settings storeSettings() const {
+        return { (uint32_t)SdfPixelSize, (uint32_t)SdfSpread, (uint32_t)SdfSupersample, (uint32_t)NominalPixelSize };
+    }
+
+    size_t storeCapacity() const { return (size_t)cellsPerRow * cellsPerRow; }
+
+    bool openFace(const std::string& fontPath) {
+        std::error_code ec;
+        if (!ft || !std::filesystem::exists(fontPath, ec)) return false;
+        FontFace face;
+        face.path = fontPath;
+        if (FT_New_Face(ft, fontPath.c_str(), 0, &face.face) != 0) return false;
+        FT_Set_Pixel_Sizes(face.face, 0, renderSize());
+        std::cout << "Loaded font from: " << fontPath << std::endl;
+
+        if (mode == GlyphMode::Sdf) {
+            std::vector<BakedFont::Glyph> stored;
+            std::string cachePath = BakedFont::PathFor(fontPath, SdfPixelSize);
+            if (BakedFont::Read(cachePath, fontPath, storeSettings(), stored)) {
+                for (BakedFont::Glyph& glyph : stored) {
+                    uint32_t index = glyph.record.glyphIndex;
+                    face.storeUse[index] = 0;
+                    face.store[index] = std::move(glyph);
+                }
+                std::cout << "Loaded " << face.store.size() << " glyph fields from cache: " << cachePath << std::endl;
+            }
+        }
+        faces.push_back(std::move(face));
+        return true;
+    }
+
+    void saveStore(const FontFace& face) const {
+        std::vector<const BakedFont::Glyph*> glyphs;
+        glyphs.reserve(face.store.size());
+        for (const auto& stored : face.store) glyphs.push_back(&stored.second);
+        BakedFont::Write(glyphs, storeSettings(), face.path, BakedFont::PathFor(face.path, SdfPixelSize));
+    }
+
+    // Field (or coverage bitmap) and metrics of a glyph, from the store or FreeType
+    const BakedFont::Glyph* field(FontFace& face, uint32_t glyphIndex, BakedFont::Glyph& scratch) {
+        bool sdf = mode == GlyphMode::Sdf;
+        if (sdf) {
+            auto stored = face.store.find(glyphIndex);
+            if (stored != face.store.end()) {
+                face.storeUse[glyphIndex] = ++storeTick;
+                return &stored->second;
+            }
+        }
+
+        if (FT_Load_Glyph(face.face, glyphIndex, FT_LOAD_RENDER)) {
+            std::cerr << "ERROR::FREETYTPE: Failed to load Glyph " << glyphIndex << std::endl;
+            return nullptr;
+        }
+        FrameStats::Instance().RecordGlyphRasterized();
+        const FT_GlyphSlot glyph = face.face->glyph;
+        const FT_Bitmap& bitmap = glyph->bitmap;
+        BakedFont::Glyph& result = scratch;
+        result.record = {};
+        result.record.glyphIndex = glyphIndex;
+        result.record.advance = FromFontUnits(glyph->advance.x);
+        int width = 0, rows = 0;
+        if (bitmap.width == 0 || bitmap.rows == 0) {
+            // Blank glyph (space): advance only, no field and no atlas cell
+            result.pixels.clear();
+        } else if (sdf) {
+            // The field adds SdfSpread texels around the glyph; metrics include that margin
+            result.pixels = SdfGenerator::Generate(bitmap.buffer, (int)bitmap.width, (int)bitmap.rows, bitmap.pitch,
+                                                   SdfSpread, SdfSupersample, width, rows);
+            float margin = (float)(SdfSpread * SdfSupersample);
+            result.record.bearing[0] = (glyph->bitmap_left - margin) * toNominal();
+            result.record.bearing[1] = (glyph->bitmap_top + margin) * toNominal();
+        } else {
+            width = (int)bitmap.width;
+            rows = (int)bitmap.rows;
+            result.pixels.resize((size_t)width * rows);
+            for (int row = 0; row < rows; ++row) {
+                std::copy_n(bitmap.buffer + (size_t)row * bitmap.pitch, width, &result.pixels[(size_t)row * width]);
+            }
+            result.record.bearing[0] = (float)glyph->bitmap_left;
+            result.record.bearing[1] = (float)glyph->bitmap_top;
+        }
+        result.record.width = (uint16_t)width;
+        result.record.height = (uint16_t)rows;
+        if (!sdf) return &result;
+
+        // Keep the field for the disk cache, forgetting the longest-unused one when full
+        if (face.store.size() >= storeCapacity()) {
+            auto oldest = std::min_element(face.storeUse.begin(), face.storeUse.end(),
+                                           [](const auto& a, const auto& b) { return a.second < b.second; });
+            face.store.erase(oldest->first);
+            face.storeUse.erase(oldest);
+        }
+        face.storeUse[glyphIndex] = ++storeTick;
+        face.storeDirty = true;
+        return &(face.store[glyphIndex] = std::move(result));
+    }
+
+    // A free cell, or the least recently used glyph's if it wasn't used this frame; -1 if none
+    int takeCell() {
+        if (!freeCells.empty()) {
+            int cell = freeCells.back();
+            freeCells.pop_back();
+            return cell;
+        }
+        if (lru.empty()) return -1;
+        auto victim = entries.find(lru.back());
+        if (victim->second.lastFrame == frame) return -1;
+        int cell = victim->second.cell;
+        lru.pop_back();
+        entries.erase(victim);
+        generation++;
+        FrameStats::Instance().RecordGlyphEviction();
+        return cell;
+    }
+
+    const Character* load(uint32_t key) {
+        int faceIndex = (int)(key >> 24);
+        uint32_t glyphIndex = key & 0xFFFFFFu;
+        if (faceIndex >= (int)faces.size()) return nullptr;
+
+        BakedFont::Glyph scratch;
+        const BakedFont::Glyph* glyph = field(faces[faceIndex], glyphIndex, scratch);
+        if (!glyph) return nullptr;
+        const BakedFont::GlyphRecord& record = glyph->record;
+
+        Entry entry;
+        float texel = mode == GlyphMode::Sdf ? SdfSupersample * toNominal() : 1.0f;
+        entry.character.Size = glm::vec2(record.width, record.height) * texel;
+        entry.character.Bearing = glm::vec2(record.bearing[0], record.bearing[1]);
+        entry.character.Advance = record.advance;
+
+        int fit = cellSize - GlyphPadding;
+        bool drawable = record.width > 0 && record.height > 0;
+        if (drawable && (record.width > fit || record.height > fit)) {
+            std::cerr << "Glyph " << glyphIndex << " (" << record.width << "x" << record.height
+                      << ") does not fit a " << fit << "px atlas cell; skipped" << std::endl;
+            drawable = false;
+            entry.character.Size = glm::vec2(0.0f);
+        }
+        if (drawable) {
+            int cell = takeCell();
+            if (cell < 0) {
+                if (!warnedFull) {
+                    std::cerr << "Glyph atlas is full for this frame; some text is not drawn" << std::endl;
+                    warnedFull = true;
+                }
+                return nullptr;
+            }
+            uploadCell(cell, *glyph);
+            glm::ivec2 origin((cell % cellsPerRow) * cellSize + GlyphPadding, (cell / cellsPerRow) * cellSize + GlyphPadding);
+            entry.character.UVMin = glm::vec2(origin) / (float)AtlasSize;
+            entry.character.UVMax = glm::vec2(origin + glm::ivec2(record.width, record.height)) / (float)AtlasSize;
+            entry.cell = cell;
+            entry.lastFrame = frame;
+            lru.push_front(key);
+            entry.lruPosition = lru.begin();
+        }
+        return &entries.emplace(key, entry).first->second.character;
+    }
+
+    // Write 'glyph' into 'cell', clearing whatever the previous occupant left around it
+    void uploadCell(int cell, const BakedFont::Glyph& glyph) {
+        int fit = cellSize - GlyphPadding;
+        cellPixels.assign((size_t)fit * fit, 0);
+        for (int row = 0; row < glyph.record.height; ++row) {
+            std::copy_n(&glyph.pixels[(size_t)row * glyph.record.width], glyph.record.width, &cellPixels[(size_t)row * fit]);
+        }
+        RenderState::Instance().BindTexture(0, GL_TEXTURE_2D, atlasTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, (cell % cellsPerRow) * cellSize + GlyphPadding, (cell / cellsPerRow) * cellSize + GlyphPadding,
+                        fit, fit, GL_RED, GL_UNSIGNED_BYTE, cellPixels.data());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+};
+
+#endif
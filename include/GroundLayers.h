@@ -0,0 +1,53 @@
+#ifndef GROUND_LAYERS_H
+#define GROUND_LAYERS_H
+
+#include "ImageLoader.h"
+
+#include <string>
+#include <vector>
+
+// Images of the ground's GL_TEXTURE_2D_ARRAY. asset_baker bakes them as one set (same size,
+// block format and mip count) so the game can upload every level as-is.
+namespace GroundLayers {
+
+constexpr const char* Grass = "assets/textures/grass.jpg";
+constexpr const char* Lake = "assets/textures/lake.png";
+constexpr const char* Street = "assets/textures/street.jpg";
+constexpr const char* Bridge = "assets/Bridge/textures/istockphoto-1145602814-170667a.jpg";
+
+// The bridge planks already laid over the water, so the shader fetches one layer per fragment
+// instead of blending two. It has no image of its own: asset_baker writes it from Bridge and
+// Lake as <BridgeOverWater>.ttex, stamped with the Bridge source.
+constexpr const char* BridgeOverWater = "assets/Bridge/textures/bridge_over_water.png";
+
+// Layer order matches the zone cycle in ground_fragment.glsl
+inline const std::vector<std::string>& Layers() {
+    static const std::vector<std::string> layers = { Grass, Lake, Street, BridgeOverWater };
+    return layers;
+}
+
+// Solid-colour stand-in for a missing layer image, coloured after the layer it replaces
+// (chosen from the file name)
+inline void FillMissing(const std::string& path, ImageData& out, int channels = 3) {
+    if (path.find("street") != std::string::npos) {
+        ImageLoader::FillSolid(out, 128, 128, 60, 60, 60, channels); // Gray
+    } else if (path.find("grass") != std::string::npos) {
+        ImageLoader::FillSolid(out, 128, 128, 34, 139, 34, channels); // Green
+    } else if (path.find("lake") != std::string::npos) {
+        ImageLoader::FillSolid(out, 128, 128, 30, 144, 255, channels); // Blue
+    } else {
+        ImageLoader::FillSolid(out, 128, 128, 0, 0, 0, channels);
+    }
+}
+
+// Blend 80% 'bridge' over 20% 'water' in place. Both must be raw images of the same size and
+// channel count.
+inline void BlendBridgeOverWater(ImageData& bridge, const ImageData& water) {
+    for (size_t i = 0; i < bridge.pixels.size(); ++i) {
+        bridge.pixels[i] = (unsigned char)(water.pixels[i] * 0.2f + bridge.pixels[i] * 0.8f + 0.5f);
+    }
+}
+
+} // namespace GroundLayers
+
+#endif
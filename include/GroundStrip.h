@@ -0,0 +1,95 @@
+#ifndef GROUND_STRIP_H
+#define GROUND_STRIP_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "RenderState.h"
+#include <cmath>
+#include <vector>
+#include <iterator>
+
+// The ground around the player as one mesh: 'zonesBehind' + 1 + 'zonesAhead' texture zones laid
+// end to end along -Z, one quad per zone, drawn with a single glDrawArrays. Zones share edges
+// instead of overlapping, so every ground pixel is shaded once.
+//
+// The mesh never changes; Placement() snaps it to the zone grid around the player each frame.
+// Texture coordinates tile every 'textureTile' units in model space, and the strip only ever
+// moves by whole zones, so the pattern stays fixed in the world while it scrolls. The fragment
+// shader still picks each zone's texture from FragPos.z.
+class GroundStrip {
+public:
+    GroundStrip(float zoneSize, int zonesBehind, int zonesAhead, float halfWidth = 500.0f, float textureTile = 10.0f)
+        : zoneSize(zoneSize), zonesBehind(zonesBehind), zoneCount(zonesBehind + 1 + zonesAhead) {
+        // positions (x, y, z) + texCoords (u, v), two triangles per zone
+        std::vector<float> vertices;
+        vertices.reserve((size_t)zoneCount * 6 * 5);
+        float u0 = -halfWidth / textureTile;
+        float u1 = halfWidth / textureTile;
+        for (int zone = 0; zone < zoneCount; ++zone) {
+            float nearZ = -zone * zoneSize;
+            float farZ = nearZ - zoneSize;
+            float nearV = nearZ / textureTile;
+            float farV = farZ / textureTile;
+            float quad[] = {
+                -halfWidth, 0.0f, farZ,   u0, farV,
+                 halfWidth, 0.0f, farZ,   u1, farV,
+                 halfWidth, 0.0f, nearZ,  u1, nearV,
+
+                 halfWidth, 0.0f, nearZ,  u1, nearV,
+                -halfWidth, 0.0f, nearZ,  u0, nearV,
+                -halfWidth, 0.0f, farZ,   u0, farV,
+            };
+            vertices.insert(vertices.end(), std::begin(quad), std::end(quad));
+        }
+        vertexCount = (GLsizei)(vertices.size() / 5);
+
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+
+        RenderState::Instance().BindVertexArray(VAO);
+
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+
+        // Position attribute
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+
+        // Texture coordinate attribute
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        RenderState::Instance().BindVertexArray(0);
+    }
+
+    ~GroundStrip() {
+        if (VBO != 0) glDeleteBuffers(1, &VBO);
+        if (VAO != 0) glDeleteVertexArrays(1, &VAO);
+    }
+
+    GroundStrip(const GroundStrip&) = delete;
+    GroundStrip& operator=(const GroundStrip&) = delete;
+
+    // Model matrix that puts the strip's first zone 'zonesBehind' zones behind the one containing 'playerZ'
+    glm::mat4 Placement(float playerZ) const {
+        int playerZone = (int)std::floor(-playerZ / zoneSize);
+        float startZ = -(playerZone - zonesBehind) * zoneSize;
+        return glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, startZ));
+    }
+
+    GLuint VertexArray() const { return VAO; }
+    GLsizei VertexCount() const { return vertexCount; }
+    int ZoneCount() const { return zoneCount; }
+
+private:
+    GLuint VAO = 0;
+    GLuint VBO = 0;
+    GLsizei vertexCount = 0;
+    float zoneSize;
+    int zonesBehind;
+    int zoneCount;
+};
+
+#endif
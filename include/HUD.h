@@ -5,6 +5,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include "RenderState.h"
 #include <string>
 #include <iostream>
 #include <sstream>
@@ -210,7 +211,7 @@ private:
         GLint colorLoc = glGetUniformLocation(shaderProgram, "color");
         glUniform3f(colorLoc, color.x, color.y, color.z);
         
-        glBindVertexArray(VAO);
+        RenderState::Instance().BindVertexArray(VAO);
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
         glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec2), vertices.data(), GL_DYNAMIC_DRAW);
         
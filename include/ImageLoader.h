@@ -0,0 +1,82 @@
+#ifndef IMAGE_LOADER_H
+#define IMAGE_LOADER_H
+
+#include <stb_image.h>
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+// GPU block compression of an image's levels (4x4 texel blocks); None = raw channels
+enum class BlockFormat {
+    None,
+    BC1, // RGB, 8 bytes per block
+    BC3, // RGBA, 16 bytes per block
+    BC7  // RGBA, 16 bytes per block, higher quality
+};
+
+// Decoded image in CPU memory, tightly packed rows (1-4 channels, 8 bits each)
+struct ImageData {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    std::vector<unsigned char> pixels;
+
+    // Optional precomputed mip levels 1..n, each half the size of the previous (at least 1x1).
+    // Empty means the uploader generates mipmaps itself.
+    std::vector<std::vector<unsigned char>> mips;
+    bool srgb = false; // colour stored sRGB-encoded; mips were filtered in linear space
+    BlockFormat block = BlockFormat::None; // if set, 'pixels' and 'mips' hold compressed blocks
+
+    bool valid() const { return width > 0 && height > 0 && channels > 0 && !pixels.empty(); }
+
+    static int MipSize(int baseSize, int level) {
+        int size = baseSize >> level;
+        return size > 0 ? size : 1;
+    }
+};
+
+// Portable image decoding (PNG/JPEG/...) through stb_image. CPU only and reentrant, so any
+// number of worker threads can decode at once. stb_image already produces rows top-down in
+// R,G,B,A order, which is what glTexImage2D takes, so no channel swizzle is needed.
+//
+// The stb_image implementation is compiled into the game through Model.h; tools that use this
+// header define STB_IMAGE_IMPLEMENTATION themselves.
+namespace ImageLoader {
+
+// Decode 'path' into 'out'. 'desiredChannels' 0 keeps the file's channel count.
+inline bool Decode(const std::string& path, ImageData& out, int desiredChannels = 0) {
+    int width = 0, height = 0, fileChannels = 0;
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &fileChannels, desiredChannels);
+    if (!data) {
+        std::cerr << "Warning: Failed to load image: " << path << " (" << stbi_failure_reason() << ")" << std::endl;
+        return false;
+    }
+
+    out.width = width;
+    out.height = height;
+    out.channels = desiredChannels != 0 ? desiredChannels : fileChannels;
+    out.pixels.assign(data, data + (size_t)width * height * out.channels);
+    stbi_image_free(data);
+    return true;
+}
+
+// Solid-colour RGB image (opaque RGBA with 'channels' 4), used as a stand-in when a texture
+// file is missing
+inline void FillSolid(ImageData& out, int width, int height, unsigned char r, unsigned char g, unsigned char b,
+                      int channels = 3) {
+    out.width = width;
+    out.height = height;
+    out.channels = channels;
+    out.pixels.resize((size_t)width * height * channels);
+    for (size_t i = 0; i < out.pixels.size(); i += channels) {
+        out.pixels[i] = r;
+        out.pixels[i + 1] = g;
+        out.pixels[i + 2] = b;
+        if (channels == 4) out.pixels[i + 3] = 255;
+    }
+}
+
+} // namespace ImageLoader
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef MATERIAL_MANIFEST_H
+#define MATERIAL_MANIFEST_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <iostream>
+#include <cstdint>
+
+// Maps model and mesh names to texture files, for models whose materials don't reference
+// their images. Read from assets/materials.manifest (format documented in that file).
+//
+// Everything is resolved when the manifest loads: texture paths are built and checked on disk
+// once, so importing a mesh is an in-memory lookup with no filesystem probing. Read-only after
+// loading, so worker threads can share Instance().
+class MaterialManifest {
+public:
+    static constexpr const char* DefaultPath = "assets/materials.manifest";
+
+    static const MaterialManifest& Instance() {
+        static MaterialManifest instance(DefaultPath);
+        return instance;
+    }
+
+    explicit MaterialManifest(const std::string& path) { Load(path); }
+
+    bool Load(const std::string& path) {
+        models.clear();
+        std::ifstream in(path);
+        if (!in) {
+            std::cout << "No material manifest at " << path << std::endl;
+            return false;
+        }
+
+        ModelEntry* current = nullptr;
+        std::string directory;
+        std::string line;
+        int lineNumber = 0;
+        int textureCount = 0;
+        int missingCount = 0;
+        while (std::getline(in, line)) {
+            lineNumber++;
+            line = trim(line);
+            if (line.empty() || line[0] == '#') continue;
+
+            if (line.front() == '[' && line.back() == ']') {
+                models.emplace_back();
+                current = &models.back();
+                current->patterns = split(line.substr(1, line.size() - 2), ',');
+                current->hash = hashString(line, FnvOffset);
+                directory.clear();
+                continue;
+            }
+
+            size_t equals = line.find('=');
+            if (!current || equals == std::string::npos) {
+                std::cerr << "Material manifest " << path << ":" << lineNumber << ": ignoring '" << line << "'" << std::endl;
+                continue;
+            }
+            current->hash = hashString(line, current->hash);
+            std::string key = trim(line.substr(0, equals));
+            std::string value = trim(line.substr(equals + 1));
+            if (key == "directory") {
+                directory = value;
+                continue;
+            }
+
+            MeshEntry mesh;
+            mesh.patterns = split(key, ',');
+            for (const auto& file : split(value, '|')) {
+                std::string texturePath = directory.empty() ? file : directory + "/" + file;
+                textureCount++;
+                std::error_code ec;
+                if (std::filesystem::exists(texturePath, ec)) {
+                    mesh.textures.push_back(texturePath);
+                } else {
+                    missingCount++;
+                }
+            }
+            current->meshes.push_back(std::move(mesh));
+        }
+
+        std::cout << "Material manifest: " << models.size() << " models, " << textureCount << " textures ("
+                  << missingCount << " missing)" << std::endl;
+        return true;
+    }
+
+    // Textures for 'meshName' of the model at 'modelPath': every variant of its diffuse map,
+    // or none when the manifest has no entry. Meshes keep every variant; whoever draws the
+    // model picks one (see Mesh::Draw), so this stays a pure lookup.
+    std::vector<std::string> Resolve(const std::string& modelPath, const std::string& meshName) const {
+        for (const ModelEntry& model : models) {
+            if (!matches(model.patterns, modelPath)) continue;
+            for (const MeshEntry& mesh : model.meshes) {
+                if (matches(mesh.patterns, meshName)) return mesh.textures;
+            }
+            return {};
+        }
+        return {};
+    }
+
+    // Fingerprint of the entries applying to 'modelPath' (0 if none), stored in baked models
+    // so that editing a model's materials re-imports it
+    uint64_t Hash(const std::string& modelPath) const {
+        for (const ModelEntry& model : models) {
+            if (matches(model.patterns, modelPath)) return model.hash;
+        }
+        return 0;
+    }
+
+private:
+    static constexpr uint64_t FnvOffset = 14695981039346656037ull;
+
+    struct MeshEntry {
+        std::vector<std::string> patterns;
+        std::vector<std::string> textures; // existing files only
+    };
+
+    struct ModelEntry {
+        std::vector<std::string> patterns;
+        std::vector<MeshEntry> meshes;
+        uint64_t hash = 0;
+    };
+
+    std::vector<ModelEntry> models;
+
+    static bool matches(const std::vector<std::string>& patterns, const std::string& name) {
+        for (const auto& pattern : patterns) {
+            if (pattern == "*" || name.find(pattern) != std::string::npos) return true;
+        }
+        return false;
+    }
+
+    static std::string trim(const std::string& s) {
+        size_t begin = s.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos) return "";
+        size_t end = s.find_last_not_of(" \t\r\n");
+        return s.substr(begin, end - begin + 1);
+    }
+
+    static std::vector<std::string> split(const std::string& s, char separator) {
+        std::vector<std::string> parts;
+        std::stringstream stream(s);
+        std::string part;
+        while (std::getline(stream, part, separator)) {
+            part = trim(part);
+            if (!part.empty()) parts.push_back(part);
+        }
+        return parts;
+    }
+
+    // FNV-1a
+    static uint64_t hashString(const std::string& s, uint64_t hash) {
+        for (unsigned char c : s) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef MESH_DATA_H
+#define MESH_DATA_H
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Interleaved vertex in the exact layout uploaded to the GPU (and stored in baked files)
+struct Vertex {
+    glm::vec3 Position;
+    glm::vec3 Normal;
+    glm::vec2 TexCoords;
+};
+
+static_assert(sizeof(Vertex) == 32, "Vertex must stay tightly packed: it is written to baked files as-is");
+
+// Meshes whose indices all fit in 16 bits are uploaded/baked with GL_UNSIGNED_SHORT indices,
+// halving index memory and bandwidth
+inline bool UseShortIndices(size_t vertexCount) {
+    return vertexCount <= 0x10000;
+}
+
+inline std::vector<uint16_t> NarrowIndices(const std::vector<unsigned int>& indices) {
+    return std::vector<uint16_t>(indices.begin(), indices.end());
+}
+
+// Levels of detail per mesh, including the full-detail level 0
+constexpr int MaxLodLevels = 4;
+
+// A simplified level: index list over the same vertices as level 0
+struct MeshLod {
+    std::vector<unsigned int> indices;
+    float error = 0.0f; // simplification error relative to the mesh bounding-box diagonal
+};
+
+// CPU-side mesh produced by the importer, before any GL upload
+struct MeshData {
+    std::string name;
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<std::string> texturePaths; // resolved image files, first one is the diffuse map
+    uint32_t diffuseVariants = 1;          // texturePaths[0, diffuseVariants) are alternative diffuse
+                                           // maps (manifest variants); see Mesh::Draw
+    glm::vec3 diffuseColor = glm::vec3(1.0f);
+    glm::vec3 aabbMin = glm::vec3(0.0f);
+    glm::vec3 aabbMax = glm::vec3(0.0f);
+    float boundingRadius = 0.0f; // sphere around the AABB centre enclosing every vertex
+    std::vector<MeshLod> lods; // levels 1..MaxLodLevels-1, coarsest last (level 0 is 'indices')
+
+    void computeBounds() {
+        if (vertices.empty()) {
+            aabbMin = aabbMax = glm::vec3(0.0f);
+            boundingRadius = 0.0f;
+            return;
+        }
+        aabbMin = aabbMax = vertices[0].Position;
+        for (const auto& v : vertices) {
+            aabbMin = glm::min(aabbMin, v.Position);
+            aabbMax = glm::max(aabbMax, v.Position);
+        }
+        // Usually much tighter than half the box diagonal for rounded shapes
+        glm::vec3 center = (aabbMin + aabbMax) * 0.5f;
+        float radiusSq = 0.0f;
+        for (const auto& v : vertices) {
+            glm::vec3 d = v.Position - center;
+            radiusSq = std::max(radiusSq, glm::dot(d, d));
+        }
+        boundingRadius = std::sqrt(radiusSq);
+    }
+};
+
+// Whole model as imported from a source file (OBJ/FBX/GLB) or read back from a baked file
+struct ModelData {
+    std::string path;
+    std::string directory;
+    std::vector<MeshData> meshes;
+};
+
+#endif
@@ -0,0 +1,356 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include "MeshData.h"
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+// Import/bake-time index and vertex reordering for MeshData. CPU only, no GL.
+//
+// Optimize() runs four passes on a triangle list:
+//   1. weld      - merge bit-identical vertices (Assimp emits one vertex per face corner)
+//   2. cache     - reorder triangles for post-transform vertex cache hits (Forsyth)
+//   3. overdraw  - sort cache-friendly triangle clusters front-to-back-ish (outward facing first)
+//   4. fetch     - renumber vertices in first-use order so vertex fetches walk memory linearly
+//
+// Cache efficiency is reported as ACMR: transformed vertices per triangle on a FIFO cache
+// (3.0 = every corner misses, ~0.5-0.7 is good for typical meshes).
+namespace MeshOptimizer {
+
+constexpr unsigned int FifoCacheSize = 16;  // used to measure ACMR and find cluster boundaries
+constexpr float OverdrawThreshold = 1.05f;  // max ACMR regression accepted for the overdraw sort
+
+struct Stats {
+    size_t verticesBefore = 0;
+    size_t verticesAfter = 0;
+    size_t triangles = 0;
+    size_t missesBefore = 0;  // FIFO cache misses before/after, ACMR = misses / triangles
+    size_t missesAfter = 0;
+
+    float acmrBefore() const { return triangles ? (float)missesBefore / triangles : 0.0f; }
+    float acmrAfter() const { return triangles ? (float)missesAfter / triangles : 0.0f; }
+
+    void add(const Stats& other) {
+        verticesBefore += other.verticesBefore;
+        verticesAfter += other.verticesAfter;
+        triangles += other.triangles;
+        missesBefore += other.missesBefore;
+        missesAfter += other.missesAfter;
+    }
+};
+
+// Number of vertex cache misses when drawing 'indices' through a FIFO cache of 'cacheSize'
+inline size_t CountCacheMisses(const std::vector<unsigned int>& indices, size_t vertexCount,
+                               unsigned int cacheSize = FifoCacheSize) {
+    // A vertex is in the cache if it was inserted less than 'cacheSize' insertions ago
+    std::vector<size_t> insertedAt(vertexCount, 0);
+    size_t timestamp = cacheSize + 1;
+    size_t misses = 0;
+    for (unsigned int index : indices) {
+        if (timestamp - insertedAt[index] > cacheSize) {
+            insertedAt[index] = timestamp++;
+            misses++;
+        }
+    }
+    return misses;
+}
+
+inline float ComputeACMR(const std::vector<unsigned int>& indices, size_t vertexCount,
+                         unsigned int cacheSize = FifoCacheSize) {
+    size_t triangles = indices.size() / 3;
+    return triangles ? (float)CountCacheMisses(indices, vertexCount, cacheSize) / triangles : 0.0f;
+}
+
+// Merge vertices whose position/normal/uv are bit-identical and remap the indices
+inline void WeldVertices(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    struct VertexHash {
+        size_t operator()(const Vertex& v) const {
+            // FNV-1a over the raw bytes; Vertex is tightly packed (see MeshData.h)
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&v);
+            size_t hash = 2166136261u;
+            for (size_t i = 0; i < sizeof(Vertex); ++i) {
+                hash = (hash ^ bytes[i]) * 16777619u;
+            }
+            return hash;
+        }
+    };
+    struct VertexEqual {
+        bool operator()(const Vertex& a, const Vertex& b) const {
+            return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+        }
+    };
+
+    std::unordered_map<Vertex, unsigned int, VertexHash, VertexEqual> unique;
+    unique.reserve(vertices.size());
+    std::vector<unsigned int> remap(vertices.size());
+    std::vector<Vertex> welded;
+    welded.reserve(vertices.size());
+
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        auto result = unique.emplace(vertices[i], (unsigned int)welded.size());
+        if (result.second) welded.push_back(vertices[i]);
+        remap[i] = result.first->second;
+    }
+    for (auto& index : indices) index = remap[index];
+    vertices.swap(welded);
+}
+
+// Reorder triangles for vertex cache locality using Tom Forsyth's linear-speed algorithm
+// ("Linear-Speed Vertex Cache Optimisation", 2006). Greedily emits the triangle whose
+// vertices score highest, where recently used vertices and vertices with few remaining
+// triangles score high.
+inline void OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount) {
+    const int CacheSize = 32;
+    const float CacheDecayPower = 1.5f;
+    const float LastTriScore = 0.75f;
+    const float ValenceBoostScale = 2.0f;
+    const float ValenceBoostPower = 0.5f;
+
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    auto vertexScore = [&](int cachePosition, unsigned int remaining) {
+        if (remaining == 0) return -1.0f; // no triangles left: never pick
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            if (cachePosition < 3) {
+                // Used by the last triangle; fixed score so it isn't favoured over the next ones
+                score = LastTriScore;
+            } else {
+                const float scaler = 1.0f / (CacheSize - 3);
+                score = std::pow(1.0f - (cachePosition - 3) * scaler, CacheDecayPower);
+            }
+        }
+        // Boost vertices with few triangles left so lone triangles don't get stranded
+        score += ValenceBoostScale * std::pow((float)remaining, -ValenceBoostPower);
+        return score;
+    };
+
+    // Vertex -> adjacent triangle lists (CSR layout)
+    std::vector<unsigned int> remaining(vertexCount, 0);
+    for (unsigned int index : indices) remaining[index]++;
+    std::vector<unsigned int> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] = offsets[v] + remaining[v];
+    std::vector<unsigned int> adjacency(indices.size());
+    {
+        std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (int c = 0; c < 3; ++c) adjacency[fill[indices[t * 3 + c]]++] = (unsigned int)t;
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> score(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) score[v] = vertexScore(-1, remaining[v]);
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+    }
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    std::vector<unsigned int> cache;
+    cache.reserve(CacheSize + 3);
+
+    // Remove 'tri' from the adjacency list of vertex 'v'
+    auto detach = [&](unsigned int v, unsigned int tri) {
+        unsigned int begin = offsets[v];
+        unsigned int end = begin + remaining[v];
+        for (unsigned int i = begin; i < end; ++i) {
+            if (adjacency[i] == tri) {
+                adjacency[i] = adjacency[end - 1];
+                break;
+            }
+        }
+        remaining[v]--;
+    };
+
+    size_t scanCursor = 0; // fallback linear scan when the cache has no candidates
+    long best = -1;
+    float bestScore = -1.0f;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        if (triangleScore[t] > bestScore) {
+            bestScore = triangleScore[t];
+            best = (long)t;
+        }
+    }
+
+    std::vector<unsigned int> newCache;
+    newCache.reserve(CacheSize + 3);
+    while (best >= 0) {
+        unsigned int tri = (unsigned int)best;
+        emitted[tri] = true;
+
+        // Emit and push its vertices to the front of the LRU cache
+        newCache.clear();
+        for (int c = 0; c < 3; ++c) {
+            unsigned int v = indices[tri * 3 + c];
+            output.push_back(v);
+            detach(v, tri);
+            newCache.push_back(v);
+        }
+        for (unsigned int v : cache) {
+            if (v != newCache[0] && v != newCache[1] && v != newCache[2]) newCache.push_back(v);
+        }
+        // Vertices pushed out of the cache lose their cache score
+        for (size_t i = CacheSize; i < newCache.size(); ++i) {
+            cachePosition[newCache[i]] = -1;
+            score[newCache[i]] = vertexScore(-1, remaining[newCache[i]]);
+        }
+        if (newCache.size() > (size_t)CacheSize) newCache.resize(CacheSize);
+        cache.swap(newCache);
+
+        // Rescore cached vertices and their triangles; pick the best candidate among them
+        for (size_t i = 0; i < cache.size(); ++i) {
+            cachePosition[cache[i]] = (int)i;
+            score[cache[i]] = vertexScore((int)i, remaining[cache[i]]);
+        }
+        best = -1;
+        bestScore = -1.0f;
+        for (unsigned int v : cache) {
+            for (unsigned int i = offsets[v]; i < offsets[v] + remaining[v]; ++i) {
+                unsigned int t = adjacency[i];
+                float s = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+                triangleScore[t] = s;
+                if (s > bestScore) {
+                    bestScore = s;
+                    best = (long)t;
+                }
+            }
+        }
+
+        // Cache exhausted (disconnected piece finished): continue with the next unemitted triangle
+        if (best < 0) {
+            while (scanCursor < triangleCount && emitted[scanCursor]) scanCursor++;
+            if (scanCursor < triangleCount) best = (long)scanCursor;
+        }
+    }
+
+    indices.swap(output);
+}
+
+// Reorder clusters of triangles so outward-facing ones come first, reducing overdraw
+// (after Sander, Nehab & Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced
+// Overdraw", 2007). Clusters are split where the FIFO cache restarts (all three corners
+// miss), so the vertex cache order inside each cluster is kept. The new order is dropped
+// if it raises ACMR by more than 'threshold'.
+inline void OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices,
+                             float threshold = OverdrawThreshold) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2) return;
+
+    // Cluster boundaries: triangles whose three vertices all miss the cache
+    std::vector<size_t> clusterStart;
+    {
+        std::vector<size_t> insertedAt(vertices.size(), 0);
+        size_t timestamp = FifoCacheSize + 1;
+        for (size_t t = 0; t < triangleCount; ++t) {
+            int misses = 0;
+            for (int c = 0; c < 3; ++c) {
+                unsigned int v = indices[t * 3 + c];
+                if (timestamp - insertedAt[v] > FifoCacheSize) {
+                    insertedAt[v] = timestamp++;
+                    misses++;
+                }
+            }
+            if (t == 0 || misses == 3) clusterStart.push_back(t);
+        }
+    }
+    if (clusterStart.size() < 2) return;
+    clusterStart.push_back(triangleCount);
+
+    // Mesh centroid (area weighted)
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const glm::vec3& a = vertices[indices[t * 3]].Position;
+        const glm::vec3& b = vertices[indices[t * 3 + 1]].Position;
+        const glm::vec3& c = vertices[indices[t * 3 + 2]].Position;
+        float area = glm::length(glm::cross(b - a, c - a));
+        meshCentroid += (a + b + c) * (area / 3.0f);
+        meshArea += area;
+    }
+    if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+    // Sort key per cluster: how far its surface faces away from the mesh centre
+    struct Cluster { size_t begin, end; float key; };
+    std::vector<Cluster> clusters;
+    for (size_t i = 0; i + 1 < clusterStart.size(); ++i) {
+        glm::vec3 centroid(0.0f), normal(0.0f);
+        float area = 0.0f;
+        for (size_t t = clusterStart[i]; t < clusterStart[i + 1]; ++t) {
+            const glm::vec3& a = vertices[indices[t * 3]].Position;
+            const glm::vec3& b = vertices[indices[t * 3 + 1]].Position;
+            const glm::vec3& c = vertices[indices[t * 3 + 2]].Position;
+            glm::vec3 n = glm::cross(b - a, c - a); // length = 2 * area
+            float triArea = glm::length(n);
+            centroid += (a + b + c) * (triArea / 3.0f);
+            normal += n;
+            area += triArea;
+        }
+        if (area > 0.0f) centroid /= area;
+        float normalLength = glm::length(normal);
+        if (normalLength > 0.0f) normal /= normalLength;
+        clusters.push_back({ clusterStart[i], clusterStart[i + 1], glm::dot(centroid - meshCentroid, normal) });
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(),
+                     [](const Cluster& a, const Cluster& b) { return a.key > b.key; });
+
+    std::vector<unsigned int> sorted;
+    sorted.reserve(indices.size());
+    for (const Cluster& cluster : clusters) {
+        sorted.insert(sorted.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+    }
+
+    size_t missesBefore = CountCacheMisses(indices, vertices.size());
+    size_t missesAfter = CountCacheMisses(sorted, vertices.size());
+    if (missesAfter <= missesBefore * threshold) indices.swap(sorted);
+}
+
+// Renumber vertices in the order the index buffer first references them; drops unused vertices
+inline void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    const unsigned int Unassigned = ~0u;
+    std::vector<unsigned int> remap(vertices.size(), Unassigned);
+    std::vector<Vertex> reordered;
+    reordered.reserve(vertices.size());
+
+    for (auto& index : indices) {
+        if (remap[index] == Unassigned) {
+            remap[index] = (unsigned int)reordered.size();
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+    vertices.swap(reordered);
+}
+
+// Run every pass on 'mesh' (a triangle list). Bounds are unchanged: only order and duplicates change.
+inline Stats Optimize(MeshData& mesh) {
+    Stats stats;
+    stats.verticesBefore = mesh.vertices.size();
+    stats.triangles = mesh.indices.size() / 3;
+    stats.missesBefore = CountCacheMisses(mesh.indices, mesh.vertices.size());
+
+    if (stats.triangles > 0 && mesh.indices.size() % 3 == 0) {
+        WeldVertices(mesh.vertices, mesh.indices);
+        OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+        OptimizeOverdraw(mesh.indices, mesh.vertices);
+        OptimizeVertexFetch(mesh.vertices, mesh.indices);
+    }
+
+    stats.verticesAfter = mesh.vertices.size();
+    stats.missesAfter = CountCacheMisses(mesh.indices, mesh.vertices.size());
+    return stats;
+}
+
+} // namespace MeshOptimizer
+
+#endif
@@ -0,0 +1,249 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include "MeshData.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+// Quadric error metric edge-collapse simplification (Garland & Heckbert, "Surface
+// Simplification Using Quadric Error Metrics", 1997), used to build mesh LODs at import/bake
+// time. CPU only, no GL.
+//
+// The result is a new index list over the SAME vertex array, so every LOD of a mesh can share
+// one vertex buffer. Collapses are half-edge collapses in position space: all vertices at the
+// removed position (UV/normal seam copies) are remapped to the most similar vertex at the kept
+// position, which avoids cracks along seams. Vertices on open borders never move.
+namespace MeshSimplifier {
+
+// Symmetric 4x4 quadric stored as its 10 unique coefficients
+struct Quadric {
+    double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+
+    static Quadric FromPlane(double a, double b, double c, double d, double weight) {
+        Quadric q;
+        q.a2 = a * a * weight; q.ab = a * b * weight; q.ac = a * c * weight; q.ad = a * d * weight;
+        q.b2 = b * b * weight; q.bc = b * c * weight; q.bd = b * d * weight;
+        q.c2 = c * c * weight; q.cd = c * d * weight;
+        q.d2 = d * d * weight;
+        return q;
+    }
+
+    void add(const Quadric& o) {
+        a2 += o.a2; ab += o.ab; ac += o.ac; ad += o.ad; b2 += o.b2;
+        bc += o.bc; bd += o.bd; c2 += o.c2; cd += o.cd; d2 += o.d2;
+    }
+
+    // Sum of squared distances to the accumulated planes
+    double eval(const glm::vec3& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        return a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+             + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+             + c2 * z * z + 2 * cd * z
+             + d2;
+    }
+};
+
+// Simplify 'indices' (triangle list over 'vertices') down to about 'targetIndexCount' indices,
+// never exceeding 'maxError' (relative to the mesh bounding-box diagonal). Returns the new index
+// list; 'resultError' receives the relative error actually introduced.
+inline std::vector<unsigned int> Simplify(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+                                          size_t targetIndexCount, float maxError, float* resultError = nullptr) {
+    std::vector<unsigned int> result = indices;
+    if (resultError) *resultError = 0.0f;
+    if (vertices.empty() || indices.size() < 3 || result.size() <= targetIndexCount) return result;
+
+    // Group vertices that share a position (seam copies) under one position id
+    struct PositionHash {
+        size_t operator()(const glm::vec3& p) const {
+            uint32_t bits[3];
+            std::memcpy(bits, &p, sizeof(bits));
+            return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+        }
+    };
+    std::unordered_map<glm::vec3, unsigned int, PositionHash> positionIds;
+    std::vector<unsigned int> positionOf(vertices.size());
+    std::vector<glm::vec3> positions;
+    std::vector<std::vector<unsigned int>> wedges; // position id -> vertices at that position
+    for (size_t v = 0; v < vertices.size(); ++v) {
+        auto found = positionIds.emplace(vertices[v].Position, (unsigned int)positions.size());
+        if (found.second) {
+            positions.push_back(vertices[v].Position);
+            wedges.emplace_back();
+        }
+        positionOf[v] = found.first->second;
+        wedges[found.first->second].push_back((unsigned int)v);
+    }
+    const size_t positionCount = positions.size();
+
+    glm::vec3 minPos = positions[0], maxPos = positions[0];
+    for (const auto& p : positions) {
+        minPos = glm::min(minPos, p);
+        maxPos = glm::max(maxPos, p);
+    }
+    double extent = glm::length(maxPos - minPos);
+    if (extent <= 0.0) return result;
+    double maxCost = (maxError * extent) * (maxError * extent);
+
+    // Border positions: on an edge that only one triangle uses (in position space)
+    std::vector<bool> locked(positionCount, false);
+    {
+        std::unordered_map<uint64_t, int> edgeUse;
+        auto edgeKey = [](unsigned int a, unsigned int b) {
+            if (a > b) std::swap(a, b);
+            return ((uint64_t)a << 32) | b;
+        };
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int e = 0; e < 3; ++e) {
+                unsigned int a = positionOf[result[i + e]], b = positionOf[result[i + (e + 1) % 3]];
+                if (a != b) edgeUse[edgeKey(a, b)]++;
+            }
+        }
+        for (const auto& entry : edgeUse) {
+            if (entry.second == 1) {
+                locked[entry.first >> 32] = true;
+                locked[entry.first & 0xffffffffu] = true;
+            }
+        }
+    }
+
+    // Per-position quadrics from the planes of the surrounding triangles
+    std::vector<Quadric> quadrics(positionCount);
+    for (size_t i = 0; i < result.size(); i += 3) {
+        glm::vec3 p0 = positions[positionOf[result[i]]];
+        glm::vec3 p1 = positions[positionOf[result[i + 1]]];
+        glm::vec3 p2 = positions[positionOf[result[i + 2]]];
+        glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+        double area = glm::length(n);
+        if (area <= 0.0) continue;
+        n /= (float)area;
+        Quadric q = Quadric::FromPlane(n.x, n.y, n.z, -glm::dot(n, p0), 1.0);
+        for (int c = 0; c < 3; ++c) quadrics[positionOf[result[i + c]]].add(q);
+    }
+
+    // Attribute distance used to pick the replacement for each seam copy
+    auto attributeDistance = [&](unsigned int a, unsigned int b) {
+        glm::vec2 duv = vertices[a].TexCoords - vertices[b].TexCoords;
+        return glm::dot(duv, duv) + (1.0f - glm::dot(vertices[a].Normal, vertices[b].Normal));
+    };
+
+    struct Collapse {
+        unsigned int from, to;
+        double cost;
+    };
+
+    double appliedCost = 0.0;
+    std::vector<unsigned int> remap(vertices.size());
+    std::vector<bool> touched(positionCount);
+    std::vector<std::vector<unsigned int>> trianglesAt(positionCount);
+
+    // Each pass collapses a batch of independent cheapest edges, then rebuilds the index list
+    while (result.size() > targetIndexCount) {
+        for (auto& list : trianglesAt) list.clear();
+        for (size_t t = 0; t < result.size() / 3; ++t) {
+            for (int c = 0; c < 3; ++c) trianglesAt[positionOf[result[t * 3 + c]]].push_back((unsigned int)t);
+        }
+
+        std::vector<Collapse> collapses;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int e = 0; e < 3; ++e) {
+                unsigned int a = positionOf[result[i + e]], b = positionOf[result[i + (e + 1) % 3]];
+                if (a >= b) continue; // one direction per triangle edge; a shared edge may appear twice
+                Quadric q = quadrics[a];
+                q.add(quadrics[b]);
+                double costAB = locked[a] ? 1e300 : q.eval(positions[b]);
+                double costBA = locked[b] ? 1e300 : q.eval(positions[a]);
+                if (costAB <= costBA && costAB <= maxCost) collapses.push_back({ a, b, costAB });
+                else if (costBA < costAB && costBA <= maxCost) collapses.push_back({ b, a, costBA });
+            }
+        }
+        if (collapses.empty()) break;
+        std::sort(collapses.begin(), collapses.end(),
+                  [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+        for (size_t v = 0; v < remap.size(); ++v) remap[v] = (unsigned int)v;
+        std::fill(touched.begin(), touched.end(), false);
+
+        // Every interior collapse removes about two triangles
+        size_t trianglesToRemove = (result.size() - targetIndexCount) / 3;
+        size_t removed = 0;
+        size_t applied = 0;
+        for (const Collapse& collapse : collapses) {
+            if (removed >= trianglesToRemove) break;
+            unsigned int from = collapse.from, to = collapse.to;
+            if (touched[from] || touched[to]) continue;
+
+            // Reject collapses that flip a surrounding triangle
+            bool flips = false;
+            for (unsigned int t : trianglesAt[from]) {
+                glm::vec3 corners[3];
+                bool hasTo = false;
+                for (int c = 0; c < 3; ++c) {
+                    unsigned int p = positionOf[result[t * 3 + c]];
+                    hasTo = hasTo || (p == to);
+                    corners[c] = positions[p];
+                }
+                if (hasTo) continue; // this triangle disappears
+                glm::vec3 before = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+                for (int c = 0; c < 3; ++c) {
+                    if (positionOf[result[t * 3 + c]] == from) corners[c] = positions[to];
+                }
+                glm::vec3 after = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+                if (glm::dot(before, after) <= 0.0f) {
+                    flips = true;
+                    break;
+                }
+            }
+            if (flips) continue;
+
+            // Move every seam copy of 'from' onto the closest matching copy of 'to'
+            for (unsigned int w : wedges[from]) {
+                unsigned int best = wedges[to][0];
+                float bestDistance = attributeDistance(w, best);
+                for (unsigned int candidate : wedges[to]) {
+                    float d = attributeDistance(w, candidate);
+                    if (d < bestDistance) {
+                        bestDistance = d;
+                        best = candidate;
+                    }
+                }
+                remap[w] = best;
+            }
+            wedges[from].clear();
+            quadrics[to].add(quadrics[from]);
+            appliedCost = std::max(appliedCost, collapse.cost);
+
+            // Neighbours must not move this pass, or the flip test above would be stale
+            for (unsigned int t : trianglesAt[from]) {
+                for (int c = 0; c < 3; ++c) touched[positionOf[result[t * 3 + c]]] = true;
+            }
+            touched[to] = true;
+            removed += 2;
+            applied++;
+        }
+        if (applied == 0) break;
+
+        // Rebuild, dropping triangles that collapsed to a line
+        std::vector<unsigned int> next;
+        next.reserve(result.size());
+        for (size_t i = 0; i < result.size(); i += 3) {
+            unsigned int a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+            unsigned int pa = positionOf[a], pb = positionOf[b], pc = positionOf[c];
+            if (pa == pb || pb == pc || pa == pc) continue;
+            next.push_back(a);
+            next.push_back(b);
+            next.push_back(c);
+        }
+        result.swap(next);
+    }
+
+    if (resultError) *resultError = (float)(std::sqrt(appliedCost) / extent);
+    return result;
+}
+
+} // namespace MeshSimplifier
+
+#endif
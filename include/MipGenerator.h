@@ -0,0 +1,156 @@
+#ifndef MIP_GENERATOR_H
+#define MIP_GENERATOR_H
+
+#include "ImageLoader.h"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+// Offline mip chain generation for baked textures (asset_baker). Each level is resampled from
+// the previous one with a separable Lanczos-2 kernel, which keeps noticeably more detail than
+// the box filter drivers use for glGenerateMipmap. sRGB colour is filtered in linear space;
+// alpha is always linear. CPU only.
+namespace MipGenerator {
+
+constexpr float LanczosRadius = 2.0f; // lobes, in destination texels
+
+inline float Lanczos(float x) {
+    x = std::fabs(x);
+    if (x < 1e-5f) return 1.0f;
+    if (x >= LanczosRadius) return 0.0f;
+    const float pi = 3.14159265358979f;
+    float px = pi * x;
+    return LanczosRadius * std::sin(px) * std::sin(px / LanczosRadius) / (px * px);
+}
+
+inline float SrgbToLinear(float c) {
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+inline float LinearToSrgb(float c) {
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+// Source texels and normalized weights contributing to one destination texel
+struct Taps {
+    int first = 0;
+    std::vector<float> weights;
+};
+
+inline std::vector<Taps> ComputeTaps(int srcSize, int dstSize) {
+    std::vector<Taps> taps(dstSize);
+    float scale = (float)srcSize / dstSize;
+    float support = LanczosRadius * scale;
+    for (int i = 0; i < dstSize; ++i) {
+        float center = (i + 0.5f) * scale;
+        int first = (int)std::floor(center - support);
+        int last = (int)std::ceil(center + support);
+        float sum = 0.0f;
+        taps[i].first = first;
+        for (int j = first; j < last; ++j) {
+            float w = Lanczos((j + 0.5f - center) / scale);
+            taps[i].weights.push_back(w);
+            sum += w;
+        }
+        for (float& w : taps[i].weights) w /= sum;
+    }
+    return taps;
+}
+
+// Texel index outside the image: wrap for tiling textures, clamp otherwise
+inline int Address(int index, int size, bool wrap) {
+    if (wrap) return ((index % size) + size) % size;
+    return std::min(std::max(index, 0), size - 1);
+}
+
+// Resample a float image (interleaved 'channels') from srcW x srcH to dstW x dstH
+inline std::vector<float> Resample(const std::vector<float>& src, int srcW, int srcH, int channels,
+                                   int dstW, int dstH, bool wrap) {
+    std::vector<Taps> tapsX = ComputeTaps(srcW, dstW);
+    std::vector<Taps> tapsY = ComputeTaps(srcH, dstH);
+
+    // Horizontal pass: srcW x srcH -> dstW x srcH
+    std::vector<float> rows((size_t)dstW * srcH * channels, 0.0f);
+    for (int y = 0; y < srcH; ++y) {
+        for (int x = 0; x < dstW; ++x) {
+            float* out = &rows[((size_t)y * dstW + x) * channels];
+            const Taps& t = tapsX[x];
+            for (size_t k = 0; k < t.weights.size(); ++k) {
+                const float* in = &src[((size_t)y * srcW + Address(t.first + (int)k, srcW, wrap)) * channels];
+                for (int c = 0; c < channels; ++c) out[c] += in[c] * t.weights[k];
+            }
+        }
+    }
+
+    // Vertical pass: dstW x srcH -> dstW x dstH
+    std::vector<float> dst((size_t)dstW * dstH * channels, 0.0f);
+    for (int y = 0; y < dstH; ++y) {
+        const Taps& t = tapsY[y];
+        float* outRow = &dst[(size_t)y * dstW * channels];
+        for (size_t k = 0; k < t.weights.size(); ++k) {
+            const float* inRow = &rows[(size_t)Address(t.first + (int)k, srcH, wrap) * dstW * channels];
+            float w = t.weights[k];
+            for (int i = 0; i < dstW * channels; ++i) outRow[i] += inRow[i] * w;
+        }
+    }
+    return dst;
+}
+
+// Resample the raw pixels of 'image' (mips are left alone) to 'width' x 'height'
+inline void Resize(ImageData& image, int width, int height, bool wrap = true) {
+    if (image.width == width && image.height == height) return;
+    std::vector<float> texels(image.pixels.begin(), image.pixels.end());
+    texels = Resample(texels, image.width, image.height, image.channels, width, height, wrap);
+    image.pixels.resize(texels.size());
+    for (size_t i = 0; i < texels.size(); ++i) {
+        image.pixels[i] = (unsigned char)std::min(std::max(texels[i] + 0.5f, 0.0f), 255.0f);
+    }
+    image.width = width;
+    image.height = height;
+}
+
+// Alpha is the last channel of 2- and 4-channel images and is never gamma-encoded
+inline bool IsAlpha(int channel, int channels) {
+    return (channels == 2 || channels == 4) && channel == channels - 1;
+}
+
+// Fill 'image.mips' with the full chain down to 1x1. 'wrap' selects tiling at the borders
+// (use it for GL_REPEAT textures).
+inline void BuildChain(ImageData& image, bool wrap = true) {
+    image.mips.clear();
+    if (!image.valid()) return;
+
+    const int channels = image.channels;
+    float toLinear[256];
+    for (int v = 0; v < 256; ++v) toLinear[v] = image.srgb ? SrgbToLinear(v / 255.0f) : v / 255.0f;
+
+    std::vector<float> level(image.pixels.size());
+    for (size_t i = 0; i < image.pixels.size(); ++i) {
+        bool alpha = IsAlpha((int)(i % channels), channels);
+        level[i] = alpha ? image.pixels[i] / 255.0f : toLinear[image.pixels[i]];
+    }
+
+    int width = image.width;
+    int height = image.height;
+    while (width > 1 || height > 1) {
+        int nextWidth = std::max(1, width / 2);
+        int nextHeight = std::max(1, height / 2);
+        level = Resample(level, width, height, channels, nextWidth, nextHeight, wrap);
+        width = nextWidth;
+        height = nextHeight;
+
+        std::vector<unsigned char> bytes(level.size());
+        for (size_t i = 0; i < level.size(); ++i) {
+            // Lanczos lobes can overshoot; clamp before quantizing
+            float v = std::min(std::max(level[i], 0.0f), 1.0f);
+            if (image.srgb && !IsAlpha((int)(i % channels), channels)) v = LinearToSrgb(v);
+            bytes[i] = (unsigned char)(v * 255.0f + 0.5f);
+        }
+        image.mips.push_back(std::move(bytes));
+    }
+}
+
+} // namespace MipGenerator
+
+#endif
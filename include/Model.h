@@ -4,11 +4,17 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
+#include "MeshData.h"
+#include "PackedVertex.h"
+#include "ModelImporter.h"
+#include "BakedModel.h"
+#include "BakedTexture.h"
+#include "TextureCache.h"
+#include "FrameStats.h"
+#include "Shader.h"
+#include "NormalMatrix.h"
 
 #include <string>
 #include <vector>
@@ -16,74 +22,184 @@
 #include <map>
 #include <fstream>
 #include <filesystem>
-
-struct Vertex {
-    glm::vec3 Position;
-    glm::vec3 Normal;
-    glm::vec2 TexCoords;
+#include <memory>
+#include <algorithm>
+
+// Per-instance vertex attributes for Mesh::DrawInstanced: the model matrix (locations 3-6,
+// one column each), a colour that replaces objectColor (location 7) and the normal matrix
+// (locations 8-10, see NormalMatrix)
+struct InstanceData {
+    glm::mat4 model;
+    glm::vec4 color;
+    glm::mat3 normal;
 };
 
+constexpr GLuint InstanceModelLocation = 3;
+constexpr GLuint InstanceColorLocation = 7;
+constexpr GLuint InstanceNormalLocation = 8;
+
 class Mesh {
 public:
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
-    std::vector<unsigned int> textures;
+    // Range of the element buffer drawn for one level of detail
+    struct Lod {
+        unsigned int firstIndex;
+        unsigned int indexCount;
+        float error; // relative to the mesh size, 0 for full detail
+    };
+
+    std::vector<TextureHandle> textures;
+    unsigned int diffuseVariants = 1; // textures[0, diffuseVariants) are alternative diffuse maps
     glm::vec3 diffuseColor;
+    glm::vec3 aabbMin, aabbMax;
+    float boundingRadius; // sphere around the AABB centre, in model space
+    unsigned int vertexCount, indexCount; // indexCount covers every LOD level in the buffer
+    GLenum indexType; // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    std::vector<Lod> lods; // level 0 = full detail
+    VertexFormat format;
+    PositionQuantization quantization; // identity for the Float format
     unsigned int VAO, VBO, EBO;
 
-    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<unsigned int> textures = {}) {
-        this->vertices = vertices;
-        this->indices = indices;
+    // Layout models imported without a baked file are packed into at load time. Packed halves
+    // vertex memory and bandwidth; Float keeps full precision (e.g. for checking quantization
+    // artefacts). Baked meshes keep the layout asset_baker wrote.
+    static inline VertexFormat DefaultFormat = VertexFormat::Packed;
+
+    // Vertex/index data is uploaded straight from the given pointers (which may point into a
+    // memory-mapped baked file); the mesh keeps no CPU copy. 'vertices' holds Vertex or
+    // PackedVertex structs according to 'format', packed ones quantized with 'quantization'.
+    // 'indices' holds uint16_t or uint32_t values according to 'indexType'; 'lods' splits them
+    // into levels (empty = one level).
+    Mesh(const void* vertices, VertexFormat format, const PositionQuantization& quantization, size_t numVertices,
+         const void* indices, size_t numIndices, GLenum indexType, std::vector<Lod> lods,
+         std::vector<TextureHandle> textures = {}) {
         this->textures = textures;
         this->diffuseColor = glm::vec3(1.0f, 1.0f, 1.0f);
-        setupMesh();
+        this->aabbMin = glm::vec3(0.0f);
+        this->aabbMax = glm::vec3(0.0f);
+        this->boundingRadius = 0.0f;
+        this->vertexCount = (unsigned int)numVertices;
+        this->indexCount = (unsigned int)numIndices;
+        this->indexType = indexType;
+        this->lods = lods.empty() ? std::vector<Lod>{ { 0, (unsigned int)numIndices, 0.0f } } : lods;
+        this->format = format;
+        this->quantization = quantization;
+        setupMesh(vertices, indices);
     }
 
-    void Draw() {
-        // Bind textures
-        for (unsigned int i = 0; i < textures.size(); i++) {
-            glActiveTexture(GL_TEXTURE0 + i);
-            glBindTexture(GL_TEXTURE_2D, textures[i]);
+    // 'variant' picks one of the alternative diffuse maps (taken modulo diffuseVariants)
+    void Draw(int lod = 0, unsigned int variant = 0) const {
+        const Lod& level = levelFor(lod);
+        beginDraw(variant);
+
+        size_t indexSize = (indexType == GL_UNSIGNED_SHORT) ? sizeof(uint16_t) : sizeof(uint32_t);
+        RenderState::Instance().BindVertexArray(VAO);
+        glDrawElements(GL_TRIANGLES, level.indexCount, indexType, (void*)(level.firstIndex * indexSize));
+        FrameStats::Instance().RecordDraw((int)(&level - lods.data()), level.indexCount / 3);
+    }
+
+    // Draw 'count' copies in one call. Per-instance data (see InstanceData) is read from
+    // 'instanceBuffer' starting at instance 'first'; the shader must have useInstancing set.
+    void DrawInstanced(int lod, unsigned int variant, GLuint instanceBuffer, size_t first, GLsizei count) const {
+        if (count <= 0) return;
+        const Lod& level = levelFor(lod);
+        beginDraw(variant);
+
+        RenderState::Instance().BindVertexArray(VAO);
+        // GL 3.3 has no base instance, so point the instanced attributes at the first instance
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        size_t base = first * sizeof(InstanceData);
+        for (int column = 0; column < 4; ++column) {
+            GLuint location = InstanceModelLocation + column;
+            glEnableVertexAttribArray(location);
+            glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                                  (void*)(base + offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
+            glVertexAttribDivisor(location, 1);
         }
-        // If shader has an "objectColor" uniform, set it to the mesh diffuse color when appropriate.
-        // However, if the shader requests an overrideColor, respect that and do not overwrite the uniform
-        GLint currentProg = 0;
-        glGetIntegerv(GL_CURRENT_PROGRAM, &currentProg);
-        if (currentProg != 0) {
-            GLint loc = glGetUniformLocation(currentProg, "objectColor");
-            GLint overrideLoc = glGetUniformLocation(currentProg, "overrideColor");
-            bool overrideActive = false;
-            if (overrideLoc != -1) {
-                GLint ov = 0;
-                // Query the current value of overrideColor from the active program
-                glGetUniformiv((GLuint)currentProg, overrideLoc, &ov);
-                overrideActive = (ov != 0);
-            }
-            if (loc != -1 && !overrideActive) {
-                glUniform3f(loc, diffuseColor.r, diffuseColor.g, diffuseColor.b);
-            }
+        glEnableVertexAttribArray(InstanceColorLocation);
+        glVertexAttribPointer(InstanceColorLocation, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(base + offsetof(InstanceData, color)));
+        glVertexAttribDivisor(InstanceColorLocation, 1);
+        for (int column = 0; column < 3; ++column) {
+            GLuint location = InstanceNormalLocation + column;
+            glEnableVertexAttribArray(location);
+            glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                                  (void*)(base + offsetof(InstanceData, normal) + column * sizeof(glm::vec3)));
+            glVertexAttribDivisor(location, 1);
         }
 
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-        
-        glActiveTexture(GL_TEXTURE0);
+        size_t indexSize = (indexType == GL_UNSIGNED_SHORT) ? sizeof(uint16_t) : sizeof(uint32_t);
+        glDrawElementsInstanced(GL_TRIANGLES, level.indexCount, indexType, (void*)(level.firstIndex * indexSize), count);
+        FrameStats::Instance().RecordDraw((int)(&level - lods.data()), level.indexCount / 3 * (unsigned int)count);
+    }
+
+    // Texture drawn on unit 0 for 'variant', 0 if the mesh has none
+    GLuint diffuseTexture(unsigned int variant) const {
+        if (textures.empty()) return 0;
+        return textures[variant % std::min<size_t>(diffuseVariants, textures.size())]->id;
+    }
+
+    // Free the GPU buffers owned by this mesh. Called by the owning Model on destruction
+    // (Mesh itself is copied around inside std::vector, so it has no destructor).
+    // Textures are shared through TextureCache and go away with their last handle.
+    void Release() {
+        if (VAO != 0) glDeleteVertexArrays(1, &VAO);
+        if (VBO != 0) glDeleteBuffers(1, &VBO);
+        if (EBO != 0) glDeleteBuffers(1, &EBO);
+        VAO = VBO = EBO = 0;
+        textures.clear();
     }
 
 private:
-    void setupMesh() {
+    const Lod& levelFor(int lod) const {
+        return lods[std::min<size_t>((size_t)std::max(lod, 0), lods.size() - 1)];
+    }
+
+    // Bind textures and set the per-mesh uniforms of the active Shader
+    void beginDraw(unsigned int variant) const {
+        // Bind textures (already-bound ones are filtered out): the chosen diffuse variant on
+        // unit 0, the textures after the variants on the following units
+        if (!textures.empty()) {
+            RenderState::Instance().BindTexture(0, GL_TEXTURE_2D, diffuseTexture(variant));
+        }
+        for (size_t i = std::min<size_t>(diffuseVariants, textures.size()); i < textures.size(); i++) {
+            GLuint unit = (GLuint)(i - diffuseVariants + 1);
+            RenderState::Instance().BindTexture(unit, GL_TEXTURE_2D, textures[i]->id);
+        }
+        const Shader* shader = Shader::Active();
+        if (shader) {
+            const DrawUniforms& u = shader->drawUniforms();
+            // Set objectColor to the mesh diffuse color unless the caller requested overrideColor
+            if (!shader->getBool(u.overrideColor)) shader->setVec3(u.objectColor, diffuseColor);
+            // Packed positions are dequantized in the vertex shader (identity for Float meshes).
+            // Nothing restores them afterwards: other float geometry sets identity itself.
+            shader->setVec3(u.posScale, quantization.scale);
+            shader->setVec3(u.posOffset, quantization.offset);
+        }
+    }
+
+    void setupMesh(const void* vertices, const void* indices) {
         glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
         glGenBuffers(1, &EBO);
 
-        glBindVertexArray(VAO);
+        RenderState::Instance().BindVertexArray(VAO);
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+        if (format == VertexFormat::Packed) {
+            setupPackedVertices(vertices);
+        } else {
+            setupFloatVertices(vertices);
+        }
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+        size_t indexSize = (indexType == GL_UNSIGNED_SHORT) ? sizeof(uint16_t) : sizeof(uint32_t);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * indexSize, indices, GL_STATIC_DRAW);
+
+        RenderState::Instance().BindVertexArray(0);
+    }
+
+    void setupFloatVertices(const void* vertices) {
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(Vertex), vertices, GL_STATIC_DRAW);
 
         // Vertex positions
         glEnableVertexAttribArray(0);
@@ -96,467 +212,302 @@ private:
         // Vertex texture coords
         glEnableVertexAttribArray(2);
         glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+    }
+
+    // Same attribute locations as the float layout; normalized integer/half attributes arrive in
+    // the shader as floats, so only the position needs the posScale/posOffset uniforms
+    void setupPackedVertices(const void* vertices) {
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(PackedVertex), vertices, GL_STATIC_DRAW);
+
+        // Vertex positions: unorm16 in [0, 1] across the mesh bounds
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
+
+        // Vertex normals: snorm 10:10:10 (w unused)
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
 
-        glBindVertexArray(0);
+        // Vertex texture coords: half floats
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, texCoords));
     }
 };
 
+// Everything needed to build a Model, gathered without touching GL so it can run on an
+// AssetLoader worker: either a mapped baked file or an Assimp import, plus decoded textures.
+struct PreparedModel {
+    std::string path;
+    std::unique_ptr<BakedModel::View> baked; // set when an up-to-date baked file exists
+    ModelData imported;                      // used when 'baked' is null
+    DecodedImages images;                    // texture path -> decoded pixels
+};
+
+// Camera data for screen-space LOD selection; main() updates Model::lodView once per frame
+struct LodView {
+    glm::vec3 cameraPos = glm::vec3(0.0f);
+    float pixelsPerUnit = 0.0f;  // viewport height / (2 tan(fovY / 2)); 0 = always full detail
+    float maxPixelError = 1.0f;  // coarsest level whose error stays under this many pixels
+    float hysteresis = 0.25f;    // switch coarser below (1 - h), back finer above (1 + h)
+};
+
 class Model {
 public:
     std::vector<Mesh> meshes;
     std::string directory;
     std::string modelPath;
     bool loaded;
-
-    Model() : loaded(false), modelPath("") {}
-
-    Model(const std::string& path) {
-        modelPath = path;
-        loaded = loadModel(path);
+    bool pending; // queued on an AssetLoader and not uploaded yet
+    glm::vec3 aabbMin, aabbMax; // union of all mesh bounds, in model space
+    glm::vec3 boundingCenter;   // bounding sphere enclosing every mesh, in model space
+    float boundingRadius;
+    std::vector<float> lodErrors; // per level, worst error of any mesh (relative to the model size)
+    unsigned int diffuseVariants = 1; // most alternative diffuse maps of any mesh
+    static inline LodView lodView; // shared by all models, see LodView
+
+    Model() : modelPath(""), loaded(false), pending(false), aabbMin(0.0f), aabbMax(0.0f),
+              boundingCenter(0.0f), boundingRadius(0.0f) {}
+
+    Model(const std::string& path) : Model() {
+        loadModel(path);
     }
 
-    bool loadModel(const std::string& path) {
-        modelPath = path;
-        Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFile(path, 
-            aiProcess_Triangulate | 
-            aiProcess_FlipUVs | 
-            aiProcess_GenNormals |
-            aiProcess_CalcTangentSpace);
-
-        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-            std::cout << "ERROR::ASSIMP::" << importer.GetErrorString() << std::endl;
-            return false;
-        }
-
-        directory = path.substr(0, path.find_last_of('/'));
-        processNode(scene->mRootNode, scene);
-        
-        std::cout << "Model loaded successfully: " << path << std::endl;
-        std::cout << "  Meshes: " << meshes.size() << std::endl;
-        
-        return true;
+    ~Model() {
+        for (auto& mesh : meshes)
+            mesh.Release();
     }
 
-    void Draw() {
-        for (unsigned int i = 0; i < meshes.size(); i++)
-            meshes[i].Draw();
+    // Models own GPU resources; share them through ModelCache instead of copying
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+
+    // Load from the baked binary next to 'path' when it is present and up to date,
+    // otherwise import the source file through Assimp
+    bool loadModel(const std::string& path) {
+        PreparedModel prepared;
+        return prepare(path, prepared) && upload(prepared);
     }
 
-private:
-    unsigned int getTextureForMesh(const std::string& meshName) {
-        std::vector<unsigned int> textureIDs;
-        
-        // Load textures for Goblin model (GoblinMutantSPDONEFINAL.fbx)
-        if (modelPath.find("goblin-3d-model-free") != std::string::npos || 
-            modelPath.find("GoblinMutant") != std::string::npos) {
-            std::cout << "DEBUG: Getting texture for goblin mesh: " << meshName << std::endl;
-            
-            std::string textureName;
-            
-            // Map mesh names to texture files based on goblin model parts
-            if (meshName.find("Body") != std::string::npos) {
-                textureName = "GoblinZBDone_Body_BaseColor.png";
-            } else if (meshName.find("Shell") != std::string::npos || meshName.find("shell") != std::string::npos) {
-                textureName = "GoblinZBDone_Shell_BaseColor.png";
-            } else if (meshName.find("WaistBand") != std::string::npos || meshName.find("waist") != std::string::npos) {
-                textureName = "GoblinZBDone_WaistBandShell_BaseColor.png";
-            } else {
-                // Default to body texture
-                textureName = "GoblinZBDone_Body_BaseColor.png";
-            }
-            
-            // Try different possible texture paths
-            std::vector<std::string> possiblePaths = {
-                directory + "/../textures/" + textureName,
-                directory + "/" + textureName,
-                "assets/goblin-3d-model-free/textures/" + textureName
-            };
-            
-            for (const auto& texturePath : possiblePaths) {
-                std::ifstream f(texturePath);
-                if (f.good()) {
-                    f.close();
-                    unsigned int textureID = loadTexture(texturePath.c_str());
-                    if (textureID != 0) {
-                        std::cout << "Successfully loaded goblin texture: " << texturePath << std::endl;
-                        return textureID;
-                    }
+    // CPU half of loading: map/import the model and decode the textures the cache doesn't
+    // already hold. Touches no GL state, so it is safe to call from a worker thread.
+    static bool prepare(const std::string& path, PreparedModel& out) {
+        out.path = path;
+
+        std::vector<std::string> texturePaths;
+        auto view = std::make_unique<BakedModel::View>();
+        if (view->Open(BakedModel::PathFor(path), path)) {
+            for (uint32_t i = 0; i < view->meshCount(); ++i) {
+                const BakedModel::MeshRecord& rec = view->mesh(i);
+                for (uint32_t t = 0; t < rec.textureCount; ++t) {
+                    texturePaths.push_back(view->string(rec.textureOffsets[t]));
                 }
-                f.close();
             }
-            
-            // Fallback: try to load any available goblin texture
-            std::vector<std::string> goblinTextures = {
-                "GoblinZBDone_Body_BaseColor.png",
-                "GoblinZBDone_Shell_BaseColor.png",
-                "GoblinZBDone_WaistBandShell_BaseColor.png"
-            };
-            
-            for (const auto& textureName : goblinTextures) {
-                std::vector<std::string> possiblePaths = {
-                    directory + "/../textures/" + textureName,
-                    directory + "/" + textureName,
-                    "assets/goblin-3d-model-free/textures/" + textureName
-                };
-                
-                for (const auto& texturePath : possiblePaths) {
-                    std::ifstream f(texturePath);
-                    if (f.good()) {
-                        f.close();
-                        unsigned int textureID = loadTexture(texturePath.c_str());
-                        if (textureID != 0) {
-                            return textureID;
-                        }
-                    }
-                    f.close();
-                }
+            out.baked = std::move(view);
+        } else {
+            if (!ModelImporter::Import(path, out.imported)) {
+                return false;
             }
-        }
-        // Load textures for new detailed turtle model (model.dae)
-        else if (modelPath.find("turtle/source/model") != std::string::npos) {
-            std::cout << "DEBUG: Getting texture for mesh: " << meshName << " (modelPath: " << modelPath << ")" << std::endl;
-            // Map mesh names to texture files based on material names from DAE
-            std::string textureName;
-            
-            if (meshName.find("tete") != std::string::npos || meshName.find("Object008") != std::string::npos) {
-                textureName = "tete_albedo.jpg";
-            } else if (meshName.find("carapace") != std::string::npos || meshName.find("Object009") != std::string::npos) {
-                textureName = "carapace_albedo.jpg";
-            } else if (meshName.find("yeux_langue") != std::string::npos || meshName.find("Object010") != std::string::npos) {
-                textureName = "yeux_langue_albedo.jpg";
-            } else if (meshName.find("pattes") != std::string::npos || meshName.find("Sphere") != std::string::npos) {
-                textureName = "pattes_albedo.jpg";
-            } else if (meshName.find("queue") != std::string::npos || meshName.find("Object011") != std::string::npos || 
-                       meshName.find("Object012") != std::string::npos || meshName.find("Object013") != std::string::npos ||
-                       meshName.find("Object014") != std::string::npos || meshName.find("Object015") != std::string::npos) {
-                textureName = "queue_albedo.jpg";
-            } else if (meshName.find("dessous") != std::string::npos || meshName.find("Object016") != std::string::npos) {
-                textureName = "dessous_albedo.jpg";
-            } else {
-                // Default texture
-                textureName = "tete_albedo.jpg";
-            }
-            
-            // Try different possible texture paths
-            std::vector<std::string> possiblePaths = {
-                directory + "/../textures/" + textureName,
-                "assets/turtle/textures/" + textureName,
-                "assets/turtle/source/model/model/textures/" + textureName
-            };
-            
-            for (const auto& texturePath : possiblePaths) {
-                std::ifstream f(texturePath);
-                if (f.good()) {
-                    f.close();
-                    unsigned int textureID = loadTexture(texturePath.c_str());
-                    if (textureID != 0) {
-                        std::cout << "Successfully loaded turtle texture: " << texturePath << std::endl;
-                        return textureID;
-                    }
-                }
-                f.close();
+            for (const MeshData& meshData : out.imported.meshes) {
+                texturePaths.insert(texturePaths.end(), meshData.texturePaths.begin(), meshData.texturePaths.end());
             }
         }
-        // Load textures for new 3D turtle model (GLB)
-        else if (modelPath.find("123b415d79b4") != std::string::npos) {
-            // Load textures from the new turtle model
-            std::vector<std::string> turtleTextures = {
-                "Image_0_0.jpeg",
-                "Image_1_1@channels=B.jpeg",
-                "Image_1_1@channels=G.jpeg"
-            };
-            
-            // Try to load first available texture
-            for (const auto& textureName : turtleTextures) {
-                std::vector<std::string> possiblePaths = {
-                    directory + "/../textures/" + textureName,
-                    directory + "/" + textureName,
-                    "assets/123b415d79b4-74f3574a4468-turtle-cartoon--3d/textures/" + textureName
-                };
-                
-                for (const auto& texturePath : possiblePaths) {
-                    std::ifstream f(texturePath);
-                    if (f.good()) {
-                        f.close();
-                        unsigned int textureID = loadTexture(texturePath.c_str());
-                        if (textureID != 0) {
-                            std::cout << "Successfully loaded turtle texture: " << texturePath << std::endl;
-                            return textureID;
-                        }
-                    }
-                    f.close();
-                }
-            }
+
+        TextureCache& cache = TextureCache::Instance();
+        for (const auto& texturePath : texturePaths) {
+            if (out.images.count(texturePath)) continue;
+            if (cache.Contains(TextureCache::Key(texturePath, SamplerDesc::Repeat()))) continue;
+            // Kept even when decoding fails: an invalid image tells upload not to try again
+            ImageData image;
+            if (!decodeImage(texturePath, image)) image = ImageData();
+            out.images[texturePath] = std::move(image);
         }
-        // Load textures for old toon turtle models
-        else if (modelPath.find("toonturtle") != std::string::npos) {
-            // Map mesh names to texture files for turtle
-            std::string textureName;
-            if (meshName.find("Shell") != std::string::npos) {
-                textureName = "Shell_fix.png";
-            } else if (meshName.find("Head") != std::string::npos) {
-                textureName = "Turtle_Head.png";
-            } else if (meshName.find("Leg") != std::string::npos || meshName.find("Feet") != std::string::npos) {
-                textureName = "Turtle_Legs.png";
-            } else if (meshName.find("Arm") != std::string::npos || meshName.find("Hand") != std::string::npos) {
-                textureName = "Turte_Arms.png";
-            } else {
-                // Default to shell texture
-                textureName = "Shell_fix.png";
-            }
+        return true;
+    }
 
-            std::string texturePath = directory + "/../textures/" + textureName;
-            std::ifstream f(texturePath);
-            if (f.good()) {
-                f.close();
-                unsigned int textureID = loadTexture(texturePath.c_str());
-                if (textureID != 0) {
-                    return textureID;
+    // GL half of loading: create buffers and textures from a prepared model. Main thread only.
+    bool upload(PreparedModel& prepared) {
+        modelPath = prepared.path;
+        directory = modelPath.substr(0, modelPath.find_last_of('/'));
+        ImageDecoder decode = TextureCache::FromDecoded(prepared.images, decodeImage);
+
+        if (prepared.baked) {
+            // Upload the vertex/index blocks directly from the mapping
+            const BakedModel::View& view = *prepared.baked;
+            meshes.reserve(view.meshCount());
+            for (uint32_t i = 0; i < view.meshCount(); ++i) {
+                const BakedModel::MeshRecord& rec = view.mesh(i);
+                std::vector<std::string> texturePaths;
+                for (uint32_t t = 0; t < rec.textureCount; ++t) {
+                    texturePaths.push_back(view.string(rec.textureOffsets[t]));
                 }
-            }
-            f.close();
-        }
-        // Load textures for car models
-        else if (modelPath.find("Retro") != std::string::npos || modelPath.find("retro") != std::string::npos) {
-            // Multiple car textures to choose from
-            std::vector<std::string> carTextures = {
-                "Retro Car.jpeg",
-                "Retro Car Purple.jpg"
-            };
-            
-            // Randomly select one texture
-            int randomIndex = rand() % carTextures.size();
-            std::string selectedTexture = carTextures[randomIndex];
-            
-            // Try different possible texture paths
-            std::vector<std::string> possiblePaths = {
-                directory + "/../textures/" + selectedTexture,
-                directory + "/" + selectedTexture,
-                "assets/free-retro-american-car-cartoon-low-poly/textures/" + selectedTexture
-            };
-            
-            for (const auto& texturePath : possiblePaths) {
-                std::cout << "Attempting to load car texture from: " << texturePath << std::endl;
-                std::ifstream f(texturePath);
-                if (f.good()) {
-                    f.close();
-                    unsigned int textureID = loadTexture(texturePath.c_str());
-                    if (textureID != 0) {
-                        std::cout << "Successfully loaded car texture: " << texturePath << std::endl;
-                        return textureID;
-                    }
-                } else {
-                    std::cout << "Car texture file not found at: " << texturePath << std::endl;
+                GLenum indexType = (rec.indexSize == 2) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+                std::vector<Mesh::Lod> lods;
+                unsigned int firstIndex = 0;
+                for (uint32_t level = 0; level < rec.lodCount; ++level) {
+                    lods.push_back({ firstIndex, rec.lodIndexCounts[level], rec.lodErrors[level] });
+                    firstIndex += rec.lodIndexCounts[level];
                 }
-                f.close();
+                addMesh(view.vertices(i), view.vertexFormat(i), view.quantization(i), rec.vertexCount,
+                        view.indices(i), firstIndex, indexType, lods,
+                        texturePaths, rec.diffuseVariants, glm::vec3(rec.diffuseColor[0], rec.diffuseColor[1], rec.diffuseColor[2]),
+                        glm::vec3(rec.aabbMin[0], rec.aabbMin[1], rec.aabbMin[2]),
+                        glm::vec3(rec.aabbMax[0], rec.aabbMax[1], rec.aabbMax[2]), rec.boundingRadius, decode);
             }
-        }
-        // Load textures for SimpleTunnel model
-        else if (modelPath.find("SimpleTunnel") != std::string::npos) {
-            // Use the COLOR texture for SimpleTunnel
-            std::string textureName = "T_SimpleTunnel_COL.png";
-            
-            // Try different possible texture paths
-            std::vector<std::string> possiblePaths = {
-                directory + "/../textures/" + textureName,
-                directory + "/textures/" + textureName,
-                "assets/SimpleTunnel/textures/" + textureName
-            };
-            
-            for (const auto& texturePath : possiblePaths) {
-                std::ifstream f(texturePath);
-                if (f.good()) {
-                    f.close();
-                    unsigned int textureID = loadTexture(texturePath.c_str());
-                    if (textureID != 0) {
-                        std::cout << "Successfully loaded tunnel texture: " << texturePath << std::endl;
-                        return textureID;
-                    }
+            std::cout << "Model loaded successfully (baked): " << modelPath << std::endl;
+        } else {
+            for (const MeshData& meshData : prepared.imported.meshes) {
+                // One element buffer per mesh: level 0 followed by the simplified levels
+                std::vector<unsigned int> indices = meshData.indices;
+                std::vector<Mesh::Lod> lods = { { 0, (unsigned int)meshData.indices.size(), 0.0f } };
+                for (const MeshLod& lod : meshData.lods) {
+                    lods.push_back({ (unsigned int)indices.size(), (unsigned int)lod.indices.size(), lod.error });
+                    indices.insert(indices.end(), lod.indices.begin(), lod.indices.end());
                 }
-                f.close();
-            }
-        }
-        // Load textures for Bridge model (bridge.glb)
-        else if (modelPath.find("bridge") != std::string::npos && modelPath.find(".glb") != std::string::npos) {
-            // Try to load bridge PNG textures
-            std::vector<std::string> bridgeTextures = {
-                "Bridge_Material_Base_Color.png",
-                "Bridge_Material_Metallic.png",
-                "Bridge_Material_Normal_DirectX.png",
-                "Bridge_Material_Roughness.png"
-            };
-            
-            for (const auto& textureName : bridgeTextures) {
-                std::vector<std::string> possiblePaths = {
-                    "assets/bridge/textures/" + textureName,
-                    directory + "/../textures/" + textureName,
-                    directory + "/" + textureName
-                };
-                
-                for (const auto& texturePath : possiblePaths) {
-                    std::ifstream f(texturePath);
-                    if (f.good()) {
-                        f.close();
-                        unsigned int textureID = loadTexture(texturePath.c_str());
-                        if (textureID != 0) {
-                            std::cout << "Successfully loaded bridge texture: " << texturePath << std::endl;
-                            return textureID;
-                        }
-                    }
-                    f.close();
+
+                // Baked files come packed already; only this fallback packs at load time
+                const void* vertices = meshData.vertices.data();
+                PositionQuantization quantization;
+                std::vector<PackedVertex> packed;
+                if (Mesh::DefaultFormat == VertexFormat::Packed) {
+                    quantization = PackVertices(meshData.vertices.data(), meshData.vertices.size(), packed);
+                    vertices = packed.data();
                 }
-            }
-        }
-        
-        return 0;
-    }
 
-    void processNode(aiNode* node, const aiScene* scene) {
-        // Process all meshes in the node
-        for (unsigned int i = 0; i < node->mNumMeshes; i++) {
-            aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-            meshes.push_back(processMesh(mesh, scene, node->mName.C_Str()));
+                if (UseShortIndices(meshData.vertices.size())) {
+                    std::vector<uint16_t> shortIndices = NarrowIndices(indices);
+                    addMesh(vertices, Mesh::DefaultFormat, quantization, meshData.vertices.size(),
+                            shortIndices.data(), shortIndices.size(), GL_UNSIGNED_SHORT, lods,
+                            meshData.texturePaths, meshData.diffuseVariants, meshData.diffuseColor,
+                            meshData.aabbMin, meshData.aabbMax, meshData.boundingRadius, decode);
+                } else {
+                    addMesh(vertices, Mesh::DefaultFormat, quantization, meshData.vertices.size(),
+                            indices.data(), indices.size(), GL_UNSIGNED_INT, lods,
+                            meshData.texturePaths, meshData.diffuseVariants, meshData.diffuseColor,
+                            meshData.aabbMin, meshData.aabbMax, meshData.boundingRadius, decode);
+                }
+            }
+            std::cout << "Model loaded successfully: " << modelPath << std::endl;
         }
+        std::cout << "  Meshes: " << meshes.size() << std::endl;
 
-        // Process children nodes
-        for (unsigned int i = 0; i < node->mNumChildren; i++) {
-            processNode(node->mChildren[i], scene);
-        }
+        loaded = true;
+        return true;
     }
 
-    Mesh processMesh(aiMesh* mesh, const aiScene* scene, const std::string& nodeName) {
-        std::vector<Vertex> vertices;
-        std::vector<unsigned int> indices;
+    bool isPending() const { return pending; }
 
-        // Debug: print mesh info for turtle model
-        if (modelPath.find("turtle/source/model") != std::string::npos) {
-            std::cout << "Processing mesh: " << nodeName << " (mesh " << mesh << ")" << std::endl;
-        }
+    // 'variant' selects each mesh's diffuse map among its alternatives (see Mesh::Draw)
+    void Draw(int lod = 0, unsigned int variant = 0) const {
+        for (unsigned int i = 0; i < meshes.size(); i++)
+            meshes[i].Draw(lod, variant);
+    }
 
-        // Process vertices
-        for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
-            Vertex vertex;
-            
-            // Position
-            vertex.Position = glm::vec3(
-                mesh->mVertices[i].x,
-                mesh->mVertices[i].y,
-                mesh->mVertices[i].z
-            );
-
-            // Normals
-            if (mesh->HasNormals()) {
-                vertex.Normal = glm::vec3(
-                    mesh->mNormals[i].x,
-                    mesh->mNormals[i].y,
-                    mesh->mNormals[i].z
-                );
-            } else {
-                vertex.Normal = glm::vec3(0.0f, 1.0f, 0.0f);
-            }
+    // Draw 'count' instances from 'instanceBuffer' (see Mesh::DrawInstanced) at level 'lod',
+    // one instanced call per mesh
+    void DrawInstanced(int lod, unsigned int variant, GLuint instanceBuffer, size_t first, GLsizei count) const {
+        for (unsigned int i = 0; i < meshes.size(); i++)
+            meshes[i].DrawInstanced(lod, variant, instanceBuffer, first, count);
+    }
 
-            // Texture coordinates
-            if (mesh->mTextureCoords[0]) {
-                vertex.TexCoords = glm::vec2(
-                    mesh->mTextureCoords[0][i].x,
-                    mesh->mTextureCoords[0][i].y
-                );
-            } else {
-                vertex.TexCoords = glm::vec2(0.0f, 0.0f);
-            }
+    // Draw at the level picked for an instance placed with 'modelMatrix'. 'lodState' is the
+    // instance's current level (kept by the caller between frames for hysteresis).
+    void Draw(const glm::mat4& modelMatrix, int& lodState, unsigned int variant = 0) const {
+        lodState = selectLod(modelMatrix, lodState);
+        Draw(lodState, variant);
+    }
 
-            vertices.push_back(vertex);
+    // Coarsest level whose simplification error, projected to the screen, stays below
+    // lodView.maxPixelError. Moving to a coarser level needs some margin below the threshold and
+    // moving back needs some margin above it, so objects near a boundary don't flicker.
+    int selectLod(const glm::mat4& modelMatrix, int currentLod) const {
+        int levels = (int)lodErrors.size();
+        if (levels <= 1 || lodView.pixelsPerUnit <= 0.0f) return 0;
+        currentLod = std::min(std::max(currentLod, 0), levels - 1);
+
+        // Projected size of the bounding sphere
+        glm::vec3 center = glm::vec3(modelMatrix * glm::vec4((aabbMin + aabbMax) * 0.5f, 1.0f));
+        float scale = std::max(glm::length(glm::vec3(modelMatrix[0])),
+                      std::max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
+        float diameter = glm::length(aabbMax - aabbMin) * scale;
+        float distance = std::max(glm::length(center - lodView.cameraPos) - diameter * 0.5f, 0.01f);
+        float sizeInPixels = diameter * lodView.pixelsPerUnit / distance;
+
+        auto pixelError = [&](int level) { return lodErrors[level] * sizeInPixels; };
+        float threshold = lodView.maxPixelError;
+
+        if (pixelError(currentLod) > threshold * (1.0f + lodView.hysteresis)) {
+            // Too coarse: refine until the error is acceptable
+            int level = currentLod;
+            while (level > 0 && pixelError(level) > threshold) level--;
+            return level;
         }
+        // Coarsen while the next level is comfortably under the threshold
+        int level = currentLod;
+        while (level + 1 < levels && pixelError(level + 1) <= threshold * (1.0f - lodView.hysteresis)) level++;
+        return level;
+    }
 
-        // Process indices
-        for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
-            aiFace face = mesh->mFaces[i];
-            for (unsigned int j = 0; j < face.mNumIndices; j++)
-                indices.push_back(face.mIndices[j]);
+private:
+    void addMesh(const void* vertices, VertexFormat format, const PositionQuantization& quantization, size_t numVertices,
+                 const void* indices, size_t numIndices, GLenum indexType, const std::vector<Mesh::Lod>& lods, const std::vector<std::string>& texturePaths, uint32_t variants, const glm::vec3& diffuseColor,
+                 const glm::vec3& meshMin, const glm::vec3& meshMax, float meshRadius, const ImageDecoder& decode) {
+        // The first 'variants' paths are alternative diffuse maps; keep every one that loads
+        std::vector<TextureHandle> textures;
+        unsigned int loadedVariants = 0;
+        for (size_t i = 0; i < texturePaths.size(); ++i) {
+            TextureHandle texture = loadTexture(texturePaths[i].c_str(), decode);
+            if (!texture) continue;
+            textures.push_back(texture);
+            if (i < variants) loadedVariants++;
         }
 
-        // Try to load an explicit material texture from the model (preferred)
-        std::vector<unsigned int> meshTextures;
-        if (mesh->mMaterialIndex >= 0 && scene && scene->mMaterials) {
-            aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-            aiString texPath;
-            if (material->GetTextureCount(aiTextureType_DIFFUSE) > 0 && material->GetTexture(aiTextureType_DIFFUSE, 0, &texPath) == AI_SUCCESS) {
-                std::string textureFile = texPath.C_Str();
-                // Try relative to model directory first
-                std::string tryPath = directory + "/" + textureFile;
-                std::ifstream f(tryPath);
-                if (f.good()) {
-                    f.close();
-                    unsigned int tid = loadTexture(tryPath.c_str());
-                    if (tid != 0) meshTextures.push_back(tid);
-                } else {
-                    f.close();
-                    // Try texture next to project assets
-                    std::string altPath = "assets/" + textureFile;
-                    std::ifstream f2(altPath);
-                    if (f2.good()) {
-                        f2.close();
-                        unsigned int tid = loadTexture(altPath.c_str());
-                        if (tid != 0) meshTextures.push_back(tid);
-                    } else {
-                        f2.close();
-                    }
-                }
-            }
+        meshes.emplace_back(vertices, format, quantization, numVertices, indices, numIndices, indexType, lods, textures);
+        Mesh& mesh = meshes.back();
+        mesh.diffuseVariants = std::max(loadedVariants, 1u);
+        diffuseVariants = std::max(diffuseVariants, mesh.diffuseVariants);
+        mesh.diffuseColor = diffuseColor;
+        mesh.aabbMin = meshMin;
+        mesh.aabbMax = meshMax;
+        mesh.boundingRadius = meshRadius;
+
+        if (meshes.size() == 1) {
+            aabbMin = meshMin;
+            aabbMax = meshMax;
+        } else {
+            aabbMin = glm::min(aabbMin, meshMin);
+            aabbMax = glm::max(aabbMax, meshMax);
         }
 
-        // If no material texture found, fall back to existing heuristics
-        if (meshTextures.empty()) {
-            unsigned int texID = getTextureForMesh(nodeName);
-            if (texID != 0) meshTextures.push_back(texID);
+        // Sphere around the model box centre that contains every mesh sphere; half the box
+        // diagonal is also a bound, so keep whichever is smaller
+        boundingCenter = (aabbMin + aabbMax) * 0.5f;
+        float radius = 0.0f;
+        for (const auto& m : meshes) {
+            radius = std::max(radius, glm::length((m.aabbMin + m.aabbMax) * 0.5f - boundingCenter) + m.boundingRadius);
         }
+        boundingRadius = std::min(radius, glm::length(aabbMax - aabbMin) * 0.5f);
 
-        Mesh m(vertices, indices, meshTextures);
-        // Attempt to read material diffuse color from Assimp material; use it as mesh diffuseColor
-        if (mesh->mMaterialIndex >= 0 && scene && scene->mMaterials) {
-            aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-            aiColor4D color;
-            if (AI_SUCCESS == material->Get(AI_MATKEY_COLOR_DIFFUSE, color)) {
-                m.diffuseColor = glm::vec3(color.r, color.g, color.b);
-            }
+        // Worst mesh error per level; a mesh with fewer levels keeps drawing its coarsest one.
+        // Mesh errors are relative to the mesh size, so using them against the (larger) model
+        // size errs on the side of detail.
+        if (lodErrors.size() < mesh.lods.size()) {
+            lodErrors.resize(mesh.lods.size(), lodErrors.empty() ? 0.0f : lodErrors.back());
+        }
+        for (size_t level = 0; level < lodErrors.size(); ++level) {
+            const Mesh::Lod& meshLod = mesh.lods[std::min(level, mesh.lods.size() - 1)];
+            lodErrors[level] = std::max(lodErrors[level], meshLod.error);
         }
-
-        return m;
     }
 
-    unsigned int loadTexture(const char* path) {
-        unsigned int textureID;
-        glGenTextures(1, &textureID);
-
-        int width, height, nrComponents;
-        unsigned char* data = stbi_load(path, &width, &height, &nrComponents, 0);
-        if (data) {
-            GLenum format = GL_RGB;
-            if (nrComponents == 1)
-                format = GL_RED;
-            else if (nrComponents == 3)
-                format = GL_RGB;
-            else if (nrComponents == 4)
-                format = GL_RGBA;
-
-            glBindTexture(GL_TEXTURE_2D, textureID);
-            glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-            glGenerateMipmap(GL_TEXTURE_2D);
-
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-            stbi_image_free(data);
-            std::cout << "Texture loaded: " << path << std::endl;
-        } else {
-            std::cout << "Failed to load texture: " << path << std::endl;
-            stbi_image_free(data);
-        }
+    // Load a texture through the shared cache; meshes/models using the same image share one GPU texture
+    TextureHandle loadTexture(const char* path, const ImageDecoder& decode) {
+        return TextureCache::Instance().Acquire(path, SamplerDesc::Repeat(), decode);
+    }
 
-        return textureID;
+    static bool decodeImage(const std::string& path, ImageData& out) {
+        if (!BakedTexture::Decode(path, out)) return false;
+        std::cout << "Texture loaded: " << path << (out.mips.empty() ? "" : " (baked mips)") << std::endl;
+        return true;
     }
 };
 
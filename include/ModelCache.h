@@ -0,0 +1,147 @@
+#ifndef MODEL_CACHE_H
+#define MODEL_CACHE_H
+
+#include "Model.h"
+#include "AssetLoader.h"
+
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <iostream>
+
+// Shared handle to a loaded model. Models handed out by the cache are immutable:
+// every Car/Player/pickup that uses the same file draws the same GPU buffers.
+using ModelHandle = std::shared_ptr<const Model>;
+
+// Process-wide registry of loaded models keyed by file path.
+// The cache only keeps weak references, so the last owner to release its handle
+// frees the Model (and its GPU buffers/textures); the next Acquire reloads it.
+class ModelCache {
+public:
+    static ModelCache& Instance() {
+        static ModelCache instance;
+        return instance;
+    }
+
+    // Return a shared handle to the model at 'path', importing it only on first use.
+    // Returns nullptr if the model could not be loaded.
+    ModelHandle Acquire(const std::string& path) {
+        return AcquireFirst({ path });
+    }
+
+    // Try each path in order and return the first one that loads (e.g. OBJ then FBX).
+    // With a loader set, a miss returns a pending placeholder right away; it fills in once
+    // the loader uploads it, or stays empty (loaded == false, pending == false) on failure.
+    ModelHandle AcquireFirst(const std::vector<std::string>& paths) {
+        for (const auto& path : paths) {
+            auto it = models.find(path);
+            if (it != models.end()) {
+                if (ModelHandle existing = it->second.lock()) {
+                    hits++;
+                    return existing;
+                }
+            }
+        }
+
+        // Don't hit the disk again for files that already failed to import
+        std::vector<std::string> candidates;
+        for (const auto& path : paths) {
+            if (!failed.count(path)) candidates.push_back(path);
+        }
+        if (candidates.empty()) return nullptr;
+
+        misses++;
+        if (loader != nullptr) {
+            return LoadAsync(candidates);
+        }
+
+        for (const auto& path : candidates) {
+            std::shared_ptr<Model> model = std::make_shared<Model>();
+            if (model->loadModel(path)) {
+                models[path] = model;
+                return model;
+            }
+            models.erase(path);
+            failed.insert(path);
+        }
+        return nullptr;
+    }
+
+    // Route misses through 'assetLoader' (nullptr = load synchronously). The loader must
+    // outlive every job it was given; unset it before destroying the loader.
+    void SetLoader(AssetLoader* assetLoader) { loader = assetLoader; }
+
+    // Number of models currently alive (held by at least one owner)
+    size_t LiveCount() const {
+        size_t count = 0;
+        for (const auto& entry : models) {
+            if (!entry.second.expired()) count++;
+        }
+        return count;
+    }
+
+    unsigned int Hits() const { return hits; }
+    unsigned int Misses() const { return misses; }
+
+    void PrintStats() const {
+        std::cout << "ModelCache: " << LiveCount() << " live models, "
+                  << hits << " hits, " << misses << " misses" << std::endl;
+    }
+
+private:
+    ModelCache() : loader(nullptr), hits(0), misses(0) {}
+    ModelCache(const ModelCache&) = delete;
+    ModelCache& operator=(const ModelCache&) = delete;
+
+    // Queue the model on the loader: the worker prepares the first candidate that imports,
+    // the upload step (main thread) fills in the placeholder
+    ModelHandle LoadAsync(const std::vector<std::string>& candidates) {
+        std::shared_ptr<Model> model = std::make_shared<Model>();
+        model->pending = true;
+        for (const auto& path : candidates) models[path] = model;
+
+        loader->Enqueue([this, model, candidates]() -> AssetLoader::UploadStep {
+            auto prepared = std::make_shared<PreparedModel>();
+            bool ok = false;
+            for (const auto& path : candidates) {
+                *prepared = PreparedModel();
+                if (Model::prepare(path, *prepared)) {
+                    ok = true;
+                    break;
+                }
+            }
+
+            return [this, model, candidates, prepared, ok]() {
+                model->pending = false;
+                if (ok && model->upload(*prepared)) {
+                    // Only the path that actually loaded keeps the entry; the ones tried before it failed
+                    bool tried = true;
+                    for (const auto& path : candidates) {
+                        if (path == model->modelPath) {
+                            tried = false;
+                            continue;
+                        }
+                        models.erase(path);
+                        if (tried) failed.insert(path);
+                    }
+                    return;
+                }
+                for (const auto& path : candidates) {
+                    models.erase(path);
+                    failed.insert(path);
+                }
+            };
+        });
+        return model;
+    }
+
+    std::unordered_map<std::string, std::weak_ptr<Model>> models;
+    std::unordered_set<std::string> failed;
+    AssetLoader* loader;
+    unsigned int hits;
+    unsigned int misses;
+};
+
+#endif
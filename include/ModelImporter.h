@@ -0,0 +1,213 @@
+#ifndef MODEL_IMPORTER_H
+#define MODEL_IMPORTER_H
+
+#include "MeshData.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MaterialManifest.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+
+// Imports a model file through Assimp into CPU-side ModelData and resolves the
+// texture file for every mesh (material first, then MaterialManifest). No GL
+// calls: used by Model at runtime and by the offline asset_baker tool.
+class ModelImporter {
+public:
+    static bool Import(const std::string& path, ModelData& out) {
+        ModelImporter importer(out);
+        return importer.load(path);
+    }
+
+private:
+    ModelData& data;
+
+    explicit ModelImporter(ModelData& target) : data(target) {}
+
+    bool load(const std::string& path) {
+        data.path = path;
+        data.meshes.clear();
+
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(path, 
+            aiProcess_Triangulate | 
+            aiProcess_FlipUVs | 
+            aiProcess_GenNormals |
+            aiProcess_CalcTangentSpace);
+
+        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+            std::cout << "ERROR::ASSIMP::" << importer.GetErrorString() << std::endl;
+            return false;
+        }
+
+        data.directory = path.substr(0, path.find_last_of('/'));
+        processNode(scene->mRootNode, scene);
+        optimizeMeshes();
+        generateLods();
+        return true;
+    }
+
+    // Weld duplicate vertices and reorder for the vertex cache / overdraw / fetch locality
+    void optimizeMeshes() {
+        MeshOptimizer::Stats total;
+        for (MeshData& mesh : data.meshes) {
+            total.add(MeshOptimizer::Optimize(mesh));
+        }
+        std::cout << "Optimized " << data.path << ": vertices " << total.verticesBefore << " -> " << total.verticesAfter
+                  << ", ACMR " << total.acmrBefore() << " -> " << total.acmrAfter() << std::endl;
+    }
+
+    // Simplified index lists for distant draws. Each level targets a fraction of level 0's
+    // triangles; generation stops early once a level can't get meaningfully smaller within the
+    // error budget (flat boxes etc. have nothing to remove).
+    void generateLods() {
+        const float ratios[MaxLodLevels - 1] = { 0.5f, 0.25f, 0.12f };
+        const float maxError = 0.05f; // 5% of the mesh size
+
+        size_t trianglesPerLevel[MaxLodLevels] = {};
+        for (MeshData& mesh : data.meshes) {
+            mesh.lods.clear();
+            trianglesPerLevel[0] += mesh.indices.size() / 3;
+            const std::vector<unsigned int>* previous = &mesh.indices;
+            for (int level = 1; level < MaxLodLevels; ++level) {
+                size_t target = (size_t)(mesh.indices.size() / 3 * ratios[level - 1]) * 3;
+                MeshLod lod;
+                lod.indices = MeshSimplifier::Simplify(mesh.vertices, *previous, target, maxError, &lod.error);
+                if (lod.indices.empty() || lod.indices.size() > previous->size() * 9 / 10) break;
+
+                MeshOptimizer::OptimizeVertexCache(lod.indices, mesh.vertices.size());
+                // Each level is simplified from the previous one, so their errors add up
+                if (!mesh.lods.empty()) lod.error += mesh.lods.back().error;
+                trianglesPerLevel[level] += lod.indices.size() / 3;
+                mesh.lods.push_back(std::move(lod));
+                previous = &mesh.lods.back().indices;
+            }
+        }
+
+        std::cout << "LODs for " << data.path << ": triangles";
+        for (int level = 0; level < MaxLodLevels; ++level) std::cout << " " << trianglesPerLevel[level];
+        std::cout << std::endl;
+    }
+
+    void processNode(aiNode* node, const aiScene* scene) {
+        // Process all meshes in the node
+        for (unsigned int i = 0; i < node->mNumMeshes; i++) {
+            aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
+            data.meshes.push_back(processMesh(mesh, scene, node->mName.C_Str()));
+        }
+
+        // Process children nodes
+        for (unsigned int i = 0; i < node->mNumChildren; i++) {
+            processNode(node->mChildren[i], scene);
+        }
+    }
+
+    MeshData processMesh(aiMesh* mesh, const aiScene* scene, const std::string& nodeName) {
+        MeshData m;
+        m.name = nodeName;
+        std::vector<Vertex>& vertices = m.vertices;
+        std::vector<unsigned int>& indices = m.indices;
+
+        // Debug: print mesh info for turtle model
+        if (data.path.find("turtle/source/model") != std::string::npos) {
+            std::cout << "Processing mesh: " << nodeName << " (mesh " << mesh << ")" << std::endl;
+        }
+
+        // Process vertices
+        for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
+            Vertex vertex;
+            
+            // Position
+            vertex.Position = glm::vec3(
+                mesh->mVertices[i].x,
+                mesh->mVertices[i].y,
+                mesh->mVertices[i].z
+            );
+
+            // Normals
+            if (mesh->HasNormals()) {
+                vertex.Normal = glm::vec3(
+                    mesh->mNormals[i].x,
+                    mesh->mNormals[i].y,
+                    mesh->mNormals[i].z
+                );
+            } else {
+                vertex.Normal = glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+
+            // Texture coordinates
+            if (mesh->mTextureCoords[0]) {
+                vertex.TexCoords = glm::vec2(
+                    mesh->mTextureCoords[0][i].x,
+                    mesh->mTextureCoords[0][i].y
+                );
+            } else {
+                vertex.TexCoords = glm::vec2(0.0f, 0.0f);
+            }
+
+            vertices.push_back(vertex);
+        }
+
+        // Process indices
+        for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
+            aiFace face = mesh->mFaces[i];
+            for (unsigned int j = 0; j < face.mNumIndices; j++)
+                indices.push_back(face.mIndices[j]);
+        }
+
+        // Try to load an explicit material texture from the model (preferred)
+        std::vector<std::string>& meshTextures = m.texturePaths;
+        if (mesh->mMaterialIndex >= 0 && scene && scene->mMaterials) {
+            aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+            aiString texPath;
+            if (material->GetTextureCount(aiTextureType_DIFFUSE) > 0 && material->GetTexture(aiTextureType_DIFFUSE, 0, &texPath) == AI_SUCCESS) {
+                std::string textureFile = texPath.C_Str();
+                // Try relative to model directory first
+                std::string tryPath = data.directory + "/" + textureFile;
+                std::ifstream f(tryPath);
+                if (f.good()) {
+                    f.close();
+                    meshTextures.push_back(tryPath);
+                } else {
+                    f.close();
+                    // Try texture next to project assets
+                    std::string altPath = "assets/" + textureFile;
+                    std::ifstream f2(altPath);
+                    if (f2.good()) {
+                        f2.close();
+                        meshTextures.push_back(altPath);
+                    } else {
+                        f2.close();
+                    }
+                }
+            }
+        }
+
+        // If no material texture found, look the mesh up in the material manifest
+        if (meshTextures.empty()) {
+            meshTextures = MaterialManifest::Instance().Resolve(data.path, nodeName);
+            if (meshTextures.size() > 1) m.diffuseVariants = (uint32_t)meshTextures.size();
+        }
+
+        m.computeBounds();
+
+        // Attempt to read material diffuse color from Assimp material; use it as mesh diffuseColor
+        if (mesh->mMaterialIndex >= 0 && scene && scene->mMaterials) {
+            aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+            aiColor4D color;
+            if (AI_SUCCESS == material->Get(AI_MATKEY_COLOR_DIFFUSE, color)) {
+                m.diffuseColor = glm::vec3(color.r, color.g, color.b);
+            }
+        }
+
+        return m;
+    }
+};
+
+#endif
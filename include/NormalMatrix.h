@@ -0,0 +1,37 @@
+#ifndef NORMAL_MATRIX_H
+#define NORMAL_MATRIX_H
+
+#include <glm/glm.hpp>
+#include <cmath>
+#include <algorithm>
+
+// Matrix that takes model-space normals to world space for 'model': the inverse transpose of
+// its upper 3x3, computed once per object on the CPU instead of per vertex in the shader.
+// The result is not normalized (the fragment shader normalizes the interpolated normal), so
+// cheaper forms are used when the transform allows it:
+//   - rotation and uniform scale: the upper 3x3 itself
+//   - rotation and per-axis scale (every GameObject): each column divided by its squared length
+//   - anything else (shear): the full inverse transpose
+inline glm::mat3 NormalMatrix(const glm::mat4& model) {
+    glm::mat3 m(model);
+    float lengthSq[3];
+    for (int i = 0; i < 3; ++i) lengthSq[i] = glm::dot(m[i], m[i]);
+    float largest = std::max(lengthSq[0], std::max(lengthSq[1], lengthSq[2]));
+    if (largest <= 0.0f) return glm::mat3(1.0f);
+
+    const float epsilon = 1e-5f * largest;
+    bool orthogonal = std::abs(glm::dot(m[0], m[1])) <= epsilon &&
+                      std::abs(glm::dot(m[0], m[2])) <= epsilon &&
+                      std::abs(glm::dot(m[1], m[2])) <= epsilon;
+    if (!orthogonal) return glm::transpose(glm::inverse(m));
+
+    bool uniform = std::abs(lengthSq[0] - lengthSq[1]) <= epsilon && std::abs(lengthSq[0] - lengthSq[2]) <= epsilon;
+    if (uniform) return m;
+
+    for (int i = 0; i < 3; ++i) {
+        if (lengthSq[i] > 0.0f) m[i] /= lengthSq[i];
+    }
+    return m;
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef PACKED_VERTEX_H
+#define PACKED_VERTEX_H
+
+#include "MeshData.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// GPU vertex layouts a Mesh can be uploaded in
+enum class VertexFormat {
+    Float,  // Vertex: 32 bytes, full precision
+    Packed  // PackedVertex: 16 bytes, quantized
+};
+
+// Compact vertex, half the size of Vertex:
+//   position  - 3 x unorm16 relative to the mesh AABB (+1 pad for 4-byte alignment),
+//               dequantized in the vertex shader as posOffset + aPos * posScale
+//   normal    - snorm 10:10:10:2 (GL_INT_2_10_10_10_REV)
+//   texCoords - 2 x half float
+struct PackedVertex {
+    uint16_t position[4];
+    uint32_t normal;
+    uint32_t texCoords;
+};
+
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must stay tightly packed");
+
+// Dequantization transform for packed positions: position = offset + unorm * scale
+struct PositionQuantization {
+    glm::vec3 offset = glm::vec3(0.0f);
+    glm::vec3 scale = glm::vec3(1.0f);
+};
+
+// Quantize 'count' vertices into 'out' and return the transform that restores the positions.
+// Quantization error is at most half a step, i.e. AABB extent / 131070 per axis.
+inline PositionQuantization PackVertices(const Vertex* vertices, size_t count, std::vector<PackedVertex>& out) {
+    PositionQuantization q;
+    out.resize(count);
+    if (count == 0) return q;
+
+    glm::vec3 minPos = vertices[0].Position;
+    glm::vec3 maxPos = vertices[0].Position;
+    for (size_t i = 1; i < count; ++i) {
+        minPos = glm::min(minPos, vertices[i].Position);
+        maxPos = glm::max(maxPos, vertices[i].Position);
+    }
+    q.offset = minPos;
+    q.scale = maxPos - minPos;
+
+    for (size_t i = 0; i < count; ++i) {
+        const Vertex& v = vertices[i];
+        PackedVertex& p = out[i];
+        for (int c = 0; c < 3; ++c) {
+            // Flat axis (scale 0): every vertex sits at the offset
+            float t = q.scale[c] > 0.0f ? (v.Position[c] - q.offset[c]) / q.scale[c] : 0.0f;
+            t = glm::clamp(t, 0.0f, 1.0f);
+            p.position[c] = static_cast<uint16_t>(t * 65535.0f + 0.5f);
+        }
+        p.position[3] = 0;
+        p.normal = glm::packSnorm3x10_1x2(glm::vec4(v.Normal, 0.0f));
+        p.texCoords = glm::packHalf2x16(v.TexCoords);
+    }
+    return q;
+}
+
+#endif
@@ -2,7 +2,7 @@
 #define PLAYER_H
 
 #include "GameObject.h"
-#include "Model.h"
+#include "ModelCache.h"
 #include <glad/glad.h>
 
 class Player : public GameObject {
@@ -15,7 +15,7 @@ public:
     bool hasSpeedBoost;
     float speedBoostTimer;
     int potionCount;
-    Model* model;
+    ModelHandle model;
     bool useModel;
 
     Player(glm::vec3 startPos) {
@@ -32,7 +32,6 @@ public:
         hasSpeedBoost = false;
         speedBoostTimer = 0.0f;
         potionCount = 0;
-        model = nullptr;
         useModel = false;
 
     // Try to load goblin model (new assets path under assets/models)
@@ -44,21 +43,13 @@ public:
         }
     }
 
-    ~Player() {
-        if (model != nullptr) {
-            delete model;
-        }
-    }
-
     void LoadModel(const std::string& path) {
-        model = new Model();
-        useModel = model->loadModel(path);
+        model = ModelCache::Instance().Acquire(path);
+        useModel = (model != nullptr);
         if (useModel) {
-            std::cout << "Player model loaded from: " << path << std::endl;
+            std::cout << (model->isPending() ? "Player model queued: " : "Player model loaded from: ") << path << std::endl;
         } else {
             std::cout << "Could not load player model, using fallback cube" << std::endl;
-            delete model;
-            model = nullptr;
         }
     }
 
@@ -125,15 +116,31 @@ public:
         return false;
     }
 
+    // True when the turtle model is ready to draw (false while streaming or on the fallback)
+    bool UsesModel() {
+        checkModelFailed();
+        return useModel && model->loaded;
+    }
+
     void Draw() override {
-        if (useModel && model != nullptr) {
-            model->Draw();
+        checkModelFailed();
+
+        if (useModel) {
+            if (model->loaded) model->Draw(GetModelMatrix(), lodLevel); // nothing to draw while still pending
         } else {
             GameObject::Draw();
         }
     }
 
 private:
+    // The model may still be streaming in; switch to the fallback once it is known to have failed
+    void checkModelFailed() {
+        if (useModel && !model->loaded && !model->isPending()) {
+            useModel = false;
+            CreateTurtleMesh();
+        }
+    }
+
     void CreateTurtleMesh() {
         // Simple turtle shape (body + head)
         vertices = {
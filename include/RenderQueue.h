@@ -0,0 +1,419 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include "Model.h"
+#include "GameObject.h"
+#include "Shader.h"
+#include "RenderState.h"
+#include "Frustum.h"
+#include "FrameStats.h"
+#include "NormalMatrix.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+// Order of the passes in the sort key. The ground goes after the other opaque geometry so
+// early depth rejection skips its (expensive) fragments under cars, bridges and the player,
+// and the sky goes last so only pixels nothing else covered run the skybox shader.
+enum class RenderPass : uint64_t {
+    Opaque = 0,
+    Ground = 1,
+    Sky = 2,
+};
+
+enum class DrawKind : uint8_t {
+    Mesh,          // one Mesh at 'lod' with 'model'/'color'
+    MeshInstanced, // one Mesh at 'lod' for 'instanceCount' instances (see Mesh::DrawInstanced)
+    Object,        // GameObject::Draw (fallback box meshes and models still streaming in)
+    Ground,        // glDrawArrays on 'vao' with the ground layer array on GroundTextureUnit
+    Sky,           // glDrawArrays on 'vao' with the cubemap 'texture', at the far plane
+};
+
+// Unit the ground's GL_TEXTURE_2D_ARRAY is bound to (groundLayers in ground_fragment.glsl).
+// Kept off unit 0, where the object textures go.
+constexpr GLuint GroundTextureUnit = 1;
+
+// Everything needed to issue one draw, captured at submit time
+struct DrawPacket {
+    uint64_t key = 0;
+    DrawKind kind = DrawKind::Mesh;
+    Shader* shader = nullptr;
+    const Mesh* mesh = nullptr;
+    int lod = 0;
+    GameObject* object = nullptr;
+    GLuint vao = 0;
+    GLsizei vertexCount = 0;
+    GLuint texture = 0; // Ground: the layer array; Sky: the cubemap
+    GLuint instanceBuffer = 0;
+    size_t firstInstance = 0;
+    GLsizei instanceCount = 0;
+    unsigned int variant = 0; // Mesh/MeshInstanced: diffuse map variant (see Mesh::Draw)
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::mat3 normal = glm::mat3(1.0f); // NormalMatrix(model), computed once per object
+    glm::vec3 color = glm::vec3(1.0f);
+    bool overrideColor = false;
+};
+
+// Per-frame list of draw packets. Collection (Submit*) only appends packets; Execute() then
+// radix-sorts them on a 64-bit key and issues them, so objects sharing a program, texture
+// set and vertex array end up next to each other and RenderState/Shader filter out the
+// repeated binds and uniform uploads.
+//
+// Key layout, most significant first:
+//   pass (2) | program (8) | first texture (16) | vertex array (16) | depth (22)
+// Depth is the distance to the camera, so each state bucket is drawn front to back.
+//
+// Models and objects are culled against the view frustum when they are submitted, so nothing
+// outside it costs a packet, a uniform upload or a draw.
+//
+// Optionally (SetDepthPrepass) every opaque packet is first drawn depth-only with a program
+// that has no fragment work; the colour pass then tests GL_LEQUAL without writing depth, so
+// each covered pixel is shaded once. With SetCountFragments each pass is wrapped in a
+// GL_SAMPLES_PASSED query and the counts end up in FrameStats, so the saving can be measured.
+class RenderQueue {
+public:
+    RenderQueue() = default;
+
+    ~RenderQueue() {
+        if (queriesCreated) glDeleteQueries(QueryLatency * (int)FragmentPass::Count, &fragmentQueries[0][0]);
+    }
+
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    // Lay depth down with 'depthShader' (same vertex stage, empty fragment stage) before the
+    // colour pass; nullptr turns the pre-pass off
+    void SetDepthPrepass(Shader* depthShader) { depthPrepass = depthShader; }
+    bool DepthPrepass() const { return depthPrepass != nullptr; }
+
+    // Count the samples each pass writes (FrameStats::FragmentLine)
+    void SetCountFragments(bool enabled) { countFragments = enabled; }
+
+    // Start a new frame seen through 'viewProjection' from 'cameraPos'; depth saturates at 'farPlane'
+    void Begin(const glm::mat4& viewProjection, const glm::vec3& cameraPos, float farPlane) {
+        packets.clear();
+        frustum = Frustum(viewProjection);
+        camera = cameraPos;
+        depthRange = farPlane;
+    }
+
+    size_t Size() const { return packets.size(); }
+
+    // Frustum test for model-space bounds placed with 'matrix'; counted in FrameStats
+    bool Visible(const glm::mat4& matrix, const glm::vec3& aabbMin, const glm::vec3& aabbMax, float radius) const {
+        bool visible = frustum.IntersectsBounds(matrix, aabbMin, aabbMax, radius);
+        FrameStats::Instance().RecordCulling(visible);
+        return visible;
+    }
+
+    bool Visible(const glm::mat4& matrix, const Model& model) const {
+        return Visible(matrix, model.aabbMin, model.aabbMax, model.boundingRadius);
+    }
+
+    // Every mesh of 'model' placed at 'matrix'. The level is picked as in Model::Draw and
+    // kept in 'lodState'. Meshes use their diffuse colour unless 'overrideColor' is set,
+    // in which case 'color' replaces their textures. 'variant' picks their diffuse maps.
+    void SubmitModel(Shader& shader, const Model& model, const glm::mat4& matrix, int& lodState,
+                     const glm::vec3& color, bool overrideColor, unsigned int variant = 0) {
+        if (!Visible(matrix, model)) return;
+        lodState = model.selectLod(matrix, lodState);
+        float depth = depthOf(matrix);
+        glm::mat3 normal = NormalMatrix(matrix);
+        for (const auto& mesh : model.meshes) {
+            DrawPacket packet;
+            packet.kind = DrawKind::Mesh;
+            packet.shader = &shader;
+            packet.mesh = &mesh;
+            packet.lod = lodState;
+            packet.model = matrix;
+            packet.normal = normal;
+            packet.color = overrideColor ? color : mesh.diffuseColor;
+            packet.overrideColor = overrideColor;
+            packet.variant = variant;
+            packet.key = MakeKey(RenderPass::Opaque, shader.ID, mesh.diffuseTexture(variant), mesh.VAO, depth);
+            packets.push_back(packet);
+        }
+    }
+
+    // Every mesh of 'model' with diffuse map 'variant', once for 'count' instances stored in
+    // 'instanceBuffer'
+    void SubmitInstanced(Shader& shader, const Model& model, int lod, unsigned int variant, GLuint instanceBuffer,
+                         size_t first, GLsizei count) {
+        if (count <= 0) return;
+        for (const auto& mesh : model.meshes) {
+            DrawPacket packet;
+            packet.kind = DrawKind::MeshInstanced;
+            packet.shader = &shader;
+            packet.mesh = &mesh;
+            packet.lod = lod;
+            packet.instanceBuffer = instanceBuffer;
+            packet.firstInstance = first;
+            packet.instanceCount = count;
+            packet.variant = variant;
+            packet.key = MakeKey(RenderPass::Opaque, shader.ID, mesh.diffuseTexture(variant), mesh.VAO, 0.0f);
+            packets.push_back(packet);
+        }
+    }
+
+    // 'object' drawn through its own Draw() with 'color'. GameObject meshes (boxes, markers)
+    // fit in the unit cube around the origin.
+    void SubmitObject(Shader& shader, GameObject& object, const glm::vec3& color) {
+        glm::mat4 matrix = object.GetModelMatrix();
+        if (!Visible(matrix, glm::vec3(-0.5f), glm::vec3(0.5f), std::sqrt(0.75f))) return;
+
+        DrawPacket packet;
+        packet.kind = DrawKind::Object;
+        packet.shader = &shader;
+        packet.object = &object;
+        packet.model = matrix;
+        packet.normal = NormalMatrix(matrix);
+        packet.color = color;
+        packet.key = MakeKey(RenderPass::Opaque, shader.ID, 0, object.VAO, depthOf(matrix));
+        packets.push_back(packet);
+    }
+
+    // The ground: 'vertexCount' vertices of 'vao' textured from the 'groundLayers' array
+    void SubmitGround(Shader& shader, GLuint vao, GLsizei vertexCount, const glm::mat4& matrix, GLuint groundLayers) {
+        DrawPacket packet;
+        packet.kind = DrawKind::Ground;
+        packet.shader = &shader;
+        packet.vao = vao;
+        packet.vertexCount = vertexCount;
+        packet.model = matrix;
+        packet.normal = NormalMatrix(matrix);
+        packet.texture = groundLayers;
+        packet.key = MakeKey(RenderPass::Ground, shader.ID, groundLayers, vao, depthOf(matrix));
+        packets.push_back(packet);
+    }
+
+    // The skybox: 'vertexCount' vertices of 'vao' sampling 'cubemap'. Its vertex shader puts
+    // it on the far plane, so it only passes the depth test where nothing else was drawn.
+    void SubmitSky(Shader& shader, GLuint vao, GLsizei vertexCount, GLuint cubemap) {
+        if (cubemap == 0) return; // not loaded (yet)
+        DrawPacket packet;
+        packet.kind = DrawKind::Sky;
+        packet.shader = &shader;
+        packet.vao = vao;
+        packet.vertexCount = vertexCount;
+        packet.texture = cubemap;
+        packet.key = MakeKey(RenderPass::Sky, shader.ID, cubemap, vao, 1.0f);
+        packets.push_back(packet);
+    }
+
+    // Sort and issue every packet submitted since Begin()
+    void Execute() {
+        sort();
+        if (countFragments) collectFragmentCounts();
+
+        if (depthPrepass) {
+            beginCount(FragmentPass::DepthPrepass);
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            for (const SortEntry& entry : order) {
+                const DrawPacket& packet = packets[entry.index];
+                if (packet.kind != DrawKind::Sky) issue(packet, *depthPrepass);
+            }
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            resetDefaults(*depthPrepass);
+            endCount();
+            // Depth is final; the colour pass only shades the fragments that won
+            glDepthFunc(GL_LEQUAL);
+            glDepthMask(GL_FALSE);
+        }
+
+        Shader* last = nullptr;
+        RenderPass current = RenderPass::Opaque;
+        bool counting = false;
+        for (const SortEntry& entry : order) {
+            const DrawPacket& packet = packets[entry.index];
+            RenderPass pass = (RenderPass)(entry.key >> 62);
+            if (!counting || pass != current) {
+                endCount();
+                if (pass == RenderPass::Sky) {
+                    // The sky sits exactly on the far plane, which the depth buffer was cleared to
+                    glDepthFunc(GL_LEQUAL);
+                    glDepthMask(GL_FALSE);
+                }
+                beginCount(fragmentPassOf(pass));
+                current = pass;
+                counting = true;
+            }
+            issue(packet, *packet.shader);
+            if (packet.kind != DrawKind::Sky) last = packet.shader;
+        }
+        endCount();
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
+
+        // Leave the last shader in its default state for whatever draws next
+        if (last) resetDefaults(*last);
+    }
+
+    static uint64_t MakeKey(RenderPass pass, GLuint program, GLuint texture, GLuint vertexArray, float depth) {
+        uint64_t depthBits = (uint64_t)(std::min(std::max(depth, 0.0f), 1.0f) * (float)DepthMask);
+        return ((uint64_t)pass << 62) |
+               ((uint64_t)(program & 0xFF) << 54) |
+               ((uint64_t)(texture & 0xFFFF) << 38) |
+               ((uint64_t)(vertexArray & 0xFFFF) << 22) |
+               (depthBits & DepthMask);
+    }
+
+private:
+    static constexpr uint64_t DepthMask = (1ull << 22) - 1;
+
+    struct SortEntry {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    std::vector<DrawPacket> packets;
+    std::vector<SortEntry> order;
+    std::vector<SortEntry> scratch;
+    Shader* depthPrepass = nullptr;
+
+    // Occlusion queries, one per pass per frame in flight; results are read QueryLatency
+    // frames later, when the GPU has long finished, so reading never stalls
+    static constexpr int QueryLatency = 3;
+    bool countFragments = false;
+    bool queriesCreated = false;
+    GLuint fragmentQueries[QueryLatency][(int)FragmentPass::Count] = {};
+    bool queryIssued[QueryLatency][(int)FragmentPass::Count] = {};
+    int querySlot = 0;
+    bool queryActive = false;
+    Frustum frustum;
+    glm::vec3 camera = glm::vec3(0.0f);
+    float depthRange = 1.0f;
+
+    // Bind state, set the per-packet uniforms of 'shader' and draw 'packet'
+    void issue(const DrawPacket& packet, Shader& shader) {
+        RenderState& state = RenderState::Instance();
+        if (state.Program() != shader.ID) shader.use();
+
+        if (packet.kind != DrawKind::Sky) {
+            const DrawUniforms& u = shader.drawUniforms();
+            shader.setBool(u.useInstancing, packet.kind == DrawKind::MeshInstanced);
+            shader.setBool(u.overrideColor, packet.overrideColor);
+            if (packet.kind != DrawKind::MeshInstanced) {
+                shader.setMat4(u.model, packet.model);
+                shader.setMat3(u.normalMatrix, packet.normal);
+                shader.setVec3(u.objectColor, packet.color);
+            }
+            // Float geometry needs identity dequantization; packed meshes set their own in
+            // Mesh::beginDraw, so consecutive packed draws only upload when the values differ
+            if (packet.kind == DrawKind::Object || packet.kind == DrawKind::Ground) {
+                shader.setVec3(u.posScale, glm::vec3(1.0f));
+                shader.setVec3(u.posOffset, glm::vec3(0.0f));
+            }
+        }
+
+        switch (packet.kind) {
+        case DrawKind::Mesh:
+            // Meshes without textures sample the default (unbound) texture
+            if (packet.mesh->textures.empty()) state.BindTexture(0, GL_TEXTURE_2D, 0);
+            packet.mesh->Draw(packet.lod, packet.variant);
+            break;
+        case DrawKind::MeshInstanced:
+            if (packet.mesh->textures.empty()) state.BindTexture(0, GL_TEXTURE_2D, 0);
+            packet.mesh->DrawInstanced(packet.lod, packet.variant, packet.instanceBuffer, packet.firstInstance, packet.instanceCount);
+            break;
+        case DrawKind::Object:
+            state.BindTexture(0, GL_TEXTURE_2D, 0);
+            packet.object->Draw();
+            break;
+        case DrawKind::Ground:
+            state.BindTexture(GroundTextureUnit, GL_TEXTURE_2D_ARRAY, packet.texture);
+            state.BindVertexArray(packet.vao);
+            glDrawArrays(GL_TRIANGLES, 0, packet.vertexCount);
+            break;
+        case DrawKind::Sky:
+            state.BindTexture(0, GL_TEXTURE_CUBE_MAP, packet.texture);
+            state.BindVertexArray(packet.vao);
+            glDrawArrays(GL_TRIANGLES, 0, packet.vertexCount);
+            break;
+        }
+    }
+
+    void resetDefaults(Shader& shader) {
+        const DrawUniforms& u = shader.drawUniforms();
+        shader.setBool(u.useInstancing, false);
+        shader.setBool(u.overrideColor, false);
+    }
+
+    static FragmentPass fragmentPassOf(RenderPass pass) {
+        switch (pass) {
+        case RenderPass::Ground: return FragmentPass::Ground;
+        case RenderPass::Sky: return FragmentPass::Sky;
+        default: return FragmentPass::Opaque;
+        }
+    }
+
+    void beginCount(FragmentPass pass) {
+        if (!countFragments) return;
+        if (!queriesCreated) {
+            glGenQueries(QueryLatency * (int)FragmentPass::Count, &fragmentQueries[0][0]);
+            queriesCreated = true;
+        }
+        glBeginQuery(GL_SAMPLES_PASSED, fragmentQueries[querySlot][(int)pass]);
+        queryIssued[querySlot][(int)pass] = true;
+        queryActive = true;
+    }
+
+    void endCount() {
+        if (!queryActive) return;
+        glEndQuery(GL_SAMPLES_PASSED);
+        queryActive = false;
+    }
+
+    // Read the results of the oldest frame in flight, then reuse its queries for this one
+    void collectFragmentCounts() {
+        querySlot = (querySlot + 1) % QueryLatency;
+        for (int pass = 0; pass < (int)FragmentPass::Count; ++pass) {
+            if (!queryIssued[querySlot][pass]) {
+                FrameStats::Instance().RecordFragments((FragmentPass)pass, 0);
+                continue;
+            }
+            GLuint query = fragmentQueries[querySlot][pass];
+            GLuint available = GL_FALSE;
+            glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available) {
+                GLuint64 samples = 0;
+                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &samples);
+                FrameStats::Instance().RecordFragments((FragmentPass)pass, samples);
+            }
+            queryIssued[querySlot][pass] = false;
+        }
+    }
+
+    // Distance from the camera to the object's origin, as a fraction of the depth range
+    float depthOf(const glm::mat4& matrix) const {
+        return glm::length(glm::vec3(matrix[3]) - camera) / depthRange;
+    }
+
+    // LSD radix sort of the keys, 8 bits per pass. Passes where every key has the same
+    // digit are skipped, which drops most of them (few programs, textures and VAOs).
+    void sort() {
+        size_t count = packets.size();
+        order.resize(count);
+        scratch.resize(count);
+        for (size_t i = 0; i < count; ++i) order[i] = { packets[i].key, (uint32_t)i };
+
+        for (int shift = 0; shift < 64; shift += 8) {
+            size_t offsets[256] = {};
+            for (const SortEntry& entry : order) offsets[(entry.key >> shift) & 0xFF]++;
+            if (count == 0 || offsets[(order[0].key >> shift) & 0xFF] == count) continue;
+
+            size_t total = 0;
+            for (size_t& offset : offsets) {
+                size_t digitCount = offset;
+                offset = total;
+                total += digitCount;
+            }
+            for (const SortEntry& entry : order) scratch[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+            order.swap(scratch);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef RENDER_STATE_H
+#define RENDER_STATE_H
+
+#include <glad/glad.h>
+#include "FrameStats.h"
+
+// CPU-side mirror of the GL binding state touched while drawing: program, vertex array,
+// active texture unit and the 2D/array/cube texture bound on each unit. Binding what is already
+// bound is skipped, and nothing is ever read back with glGet*. Uniform values are mirrored by
+// Shader itself.
+//
+// Drawing code binds through this class. Setup code (mesh creation, texture uploads) may bind
+// directly; the game loop calls Invalidate() before rendering each frame, so anything bound
+// behind the tracker's back is simply rebound on first use.
+class RenderState {
+public:
+    static constexpr int MaxTextureUnits = 16;
+
+    static RenderState& Instance() {
+        static RenderState instance;
+        return instance;
+    }
+
+    // Forget the mirrored state; the next bind of each kind is always issued
+    void Invalidate() {
+        program = Unknown;
+        vertexArray = Unknown;
+        activeUnit = Unknown;
+        for (int unit = 0; unit < MaxTextureUnits; ++unit) {
+            texture2D[unit] = Unknown;
+            texture2DArray[unit] = Unknown;
+            textureCube[unit] = Unknown;
+        }
+    }
+
+    GLuint Program() const { return program; }
+
+    void UseProgram(GLuint id) {
+        if (!changed(program, id)) return;
+        glUseProgram(id);
+    }
+
+    void BindVertexArray(GLuint id) {
+        if (!changed(vertexArray, id)) return;
+        glBindVertexArray(id);
+    }
+
+    // Bind 'id' to 'target' (GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY or GL_TEXTURE_CUBE_MAP) on texture unit 'unit'
+    void BindTexture(GLuint unit, GLenum target, GLuint id) {
+        GLuint& bound = mirrorFor(target)[unit];
+        if (!changed(bound, id)) return;
+        if (changed(activeUnit, unit)) glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(target, id);
+    }
+
+private:
+    static constexpr GLuint Unknown = 0xFFFFFFFFu; // never a valid GL name
+
+    RenderState() { Invalidate(); }
+
+    GLuint* mirrorFor(GLenum target) {
+        if (target == GL_TEXTURE_CUBE_MAP) return textureCube;
+        if (target == GL_TEXTURE_2D_ARRAY) return texture2DArray;
+        return texture2D;
+    }
+
+    // Update 'mirror' to 'value' and count the call; false if it was already bound
+    bool changed(GLuint& mirror, GLuint value) {
+        bool differs = mirror != value;
+        FrameStats::Instance().RecordStateChange(differs);
+        mirror = value;
+        return differs;
+    }
+
+    GLuint program;
+    GLuint vertexArray;
+    GLuint activeUnit;
+    GLuint texture2D[MaxTextureUnits];
+    GLuint texture2DArray[MaxTextureUnits];
+    GLuint textureCube[MaxTextureUnits];
+};
+
+#endif
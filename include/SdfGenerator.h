@@ -0,0 +1,113 @@
+#ifndef SDF_GENERATOR_H
+#define SDF_GENERATOR_H
+
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+// Signed distance fields for font glyphs (TextRenderer's SDF mode). The glyph is rasterized
+// 'supersample' times larger than the field, thresholded at half coverage, and run through an
+// exact Euclidean distance transform (Felzenszwalb & Huttenlocher) on both sides of the edge;
+// each output texel averages its block of high-resolution distances. Values are stored as
+// 0.5 + distance / (2 * spread), so 128 is the outline and 'spread' output texels either side
+// map to 0 and 255. CPU only.
+namespace SdfGenerator {
+
+// Stands in for infinity (no feature); finite so the parabola intersections below stay defined
+constexpr float Far = 1e20f;
+
+// Squared distance transform of one row/column 'f' (0 on features, Far elsewhere) into 'd'.
+// 'v' and 'z' are scratch of n and n + 1 entries.
+inline void Transform1D(const float* f, int n, float* d, int* v, float* z) {
+    const float inf = std::numeric_limits<float>::infinity();
+    int k = 0;
+    v[0] = 0;
+    z[0] = -inf;
+    z[1] = inf;
+    for (int q = 1; q < n; ++q) {
+        float s;
+        while (true) {
+            int p = v[k];
+            s = ((f[q] + (float)q * q) - (f[p] + (float)p * p)) / (2.0f * (q - p));
+            if (s > z[k] || k == 0) break;
+            --k;
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = inf;
+    }
+    k = 0;
+    for (int q = 0; q < n; ++q) {
+        while (z[k + 1] < q) ++k;
+        float dq = (float)(q - v[k]);
+        d[q] = dq * dq + f[v[k]];
+    }
+}
+
+// 2D squared distance transform of 'grid' (width x height) in place
+inline void Transform2D(std::vector<float>& grid, int width, int height) {
+    int n = std::max(width, height);
+    std::vector<float> f(n), d(n), z(n + 1);
+    std::vector<int> v(n);
+    for (int x = 0; x < width; ++x) {
+        for (int y = 0; y < height; ++y) f[y] = grid[(size_t)y * width + x];
+        Transform1D(f.data(), height, d.data(), v.data(), z.data());
+        for (int y = 0; y < height; ++y) grid[(size_t)y * width + x] = d[y];
+    }
+    for (int y = 0; y < height; ++y) {
+        float* row = &grid[(size_t)y * width];
+        Transform1D(row, width, d.data(), v.data(), z.data());
+        std::copy(d.begin(), d.begin() + width, row);
+    }
+}
+
+// Distance field of a coverage bitmap ('width' x 'rows', 'pitch' bytes per row). The field
+// has 'spread' texels of margin on every side and is 1/'supersample' of the bitmap's
+// resolution; its size is returned in 'outWidth' x 'outHeight'.
+inline std::vector<unsigned char> Generate(const unsigned char* coverage, int width, int rows, int pitch,
+                                           int spread, int supersample, int& outWidth, int& outHeight) {
+    int margin = spread * supersample;
+    outWidth = (width + 2 * margin + supersample - 1) / supersample;
+    outHeight = (rows + 2 * margin + supersample - 1) / supersample;
+    int gridWidth = outWidth * supersample;
+    int gridHeight = outHeight * supersample;
+
+    // Distance to the nearest inside texel and to the nearest outside texel
+    std::vector<float> toInside((size_t)gridWidth * gridHeight, Far);
+    std::vector<float> toOutside((size_t)gridWidth * gridHeight, 0.0f);
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (coverage[(size_t)y * pitch + x] < 128) continue;
+            size_t i = (size_t)(y + margin) * gridWidth + (x + margin);
+            toInside[i] = 0.0f;
+            toOutside[i] = Far;
+        }
+    }
+    Transform2D(toInside, gridWidth, gridHeight);
+    Transform2D(toOutside, gridWidth, gridHeight);
+
+    std::vector<unsigned char> field((size_t)outWidth * outHeight);
+    float blockArea = (float)(supersample * supersample);
+    for (int y = 0; y < outHeight; ++y) {
+        for (int x = 0; x < outWidth; ++x) {
+            float sum = 0.0f;
+            for (int sy = 0; sy < supersample; ++sy) {
+                for (int sx = 0; sx < supersample; ++sx) {
+                    size_t i = (size_t)(y * supersample + sy) * gridWidth + (x * supersample + sx);
+                    // Positive inside; the edge lies half a texel from each texel centre
+                    sum += toInside[i] == 0.0f ? std::sqrt(toOutside[i]) - 0.5f : 0.5f - std::sqrt(toInside[i]);
+                }
+            }
+            float distance = sum / blockArea / supersample; // in output texels
+            float value = 0.5f + distance / (2.0f * spread);
+            field[(size_t)y * outWidth + x] = (unsigned char)(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+        }
+    }
+    return field;
+}
+
+} // namespace SdfGenerator
+
+#endif
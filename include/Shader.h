@@ -3,11 +3,37 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include "FrameStats.h"
+#include "FrameData.h"
+#include "RenderState.h"
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
 
+// Pre-resolved uniform of one Shader (from Shader::uniformHandle). The default handle names
+// no active uniform; setting it does nothing, like glUniform* with location -1.
+struct UniformHandle {
+    int index = -1;
+    bool valid() const { return index >= 0; }
+};
+
+// Per-draw uniforms of the scene shaders (vertex_shader.glsl and the fragment shaders paired
+// with it), resolved once per Shader. A shader without one of them gets an invalid handle.
+struct DrawUniforms {
+    UniformHandle model, normalMatrix, objectColor, overrideColor, useInstancing, posScale, posOffset;
+};
+
+// GLSL program plus a table of its active uniforms, reflected once after linking. Each entry
+// keeps a CPU copy of the value last uploaded so setting the same value again skips the GL
+// call; uploads issued and skipped are counted in FrameStats. The string setters look the name
+// up in the table (no glGetUniformLocation); hot paths resolve a UniformHandle once instead.
+//
+// The shadow copies assume a program's uniforms are only changed through its Shader.
 class Shader {
 public:
     unsigned int ID;
@@ -65,37 +91,159 @@ public:
 
         glDeleteShader(vertex);
         glDeleteShader(fragment);
+
+        reflectUniforms();
+        drawHandles.model = uniformHandle("model");
+        drawHandles.normalMatrix = uniformHandle("normalMatrix");
+        drawHandles.objectColor = uniformHandle("objectColor");
+        drawHandles.overrideColor = uniformHandle("overrideColor");
+        drawHandles.useInstancing = uniformHandle("useInstancing");
+        drawHandles.posScale = uniformHandle("posScale");
+        drawHandles.posOffset = uniformHandle("posOffset");
+
+        // Shared per-frame state comes from the FrameData uniform buffer
+        GLuint frameBlock = glGetUniformBlockIndex(ID, FrameData::BlockName);
+        if (frameBlock != GL_INVALID_INDEX) glUniformBlockBinding(ID, frameBlock, FrameData::Binding);
+    }
+
+    ~Shader() {
+        if (active == this) active = nullptr;
     }
 
     void use() {
-        glUseProgram(ID);
+        RenderState::Instance().UseProgram(ID);
+        active = this;
+    }
+
+    // Shader whose use() was called last, or null. Code that binds other programs directly
+    // (HUD) restores the previous one, so this is the program currently bound for drawing.
+    static Shader* Active() { return active; }
+
+    UniformHandle uniformHandle(const std::string& name) const {
+        auto it = uniformIndex.find(name);
+        return it != uniformIndex.end() ? UniformHandle{ it->second } : UniformHandle{};
+    }
+
+    const DrawUniforms& drawUniforms() const { return drawHandles; }
+
+    void setBool(UniformHandle handle, bool value) const {
+        int v = (int)value;
+        if (changed(handle, &v, sizeof(v))) glUniform1i(uniforms[handle.index].location, v);
+    }
+
+    void setInt(UniformHandle handle, int value) const {
+        if (changed(handle, &value, sizeof(value))) glUniform1i(uniforms[handle.index].location, value);
+    }
+
+    void setFloat(UniformHandle handle, float value) const {
+        if (changed(handle, &value, sizeof(value))) glUniform1f(uniforms[handle.index].location, value);
+    }
+
+    void setVec3(UniformHandle handle, const glm::vec3& value) const {
+        if (changed(handle, &value[0], sizeof(value))) glUniform3fv(uniforms[handle.index].location, 1, &value[0]);
+    }
+
+    void setMat3(UniformHandle handle, const glm::mat3& mat) const {
+        if (changed(handle, &mat[0][0], sizeof(mat))) glUniformMatrix3fv(uniforms[handle.index].location, 1, GL_FALSE, &mat[0][0]);
+    }
+
+    void setMat4(UniformHandle handle, const glm::mat4& mat) const {
+        if (changed(handle, &mat[0][0], sizeof(mat))) glUniformMatrix4fv(uniforms[handle.index].location, 1, GL_FALSE, &mat[0][0]);
+    }
+
+    // Last value set for a bool uniform (GL initializes every uniform to 0)
+    bool getBool(UniformHandle handle) const {
+        if (!handle.valid()) return false;
+        int v = 0;
+        std::memcpy(&v, uniforms[handle.index].value, sizeof(v));
+        return v != 0;
     }
 
     void setBool(const std::string& name, bool value) const {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+        setBool(uniformHandle(name), value);
     }
 
     void setInt(const std::string& name, int value) const {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+        setInt(uniformHandle(name), value);
     }
 
     void setFloat(const std::string& name, float value) const {
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+        setFloat(uniformHandle(name), value);
     }
 
     void setVec3(const std::string& name, const glm::vec3& value) const {
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        setVec3(uniformHandle(name), value);
     }
 
     void setVec3(const std::string& name, float x, float y, float z) const {
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+        setVec3(uniformHandle(name), glm::vec3(x, y, z));
+    }
+
+    void setMat3(const std::string& name, const glm::mat3& mat) const {
+        setMat3(uniformHandle(name), mat);
     }
 
     void setMat4(const std::string& name, const glm::mat4& mat) const {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        setMat4(uniformHandle(name), mat);
     }
 
 private:
+    struct Uniform {
+        GLint location;
+        unsigned char value[sizeof(glm::mat4)]; // shadow of the last uploaded value
+    };
+
+    mutable std::vector<Uniform> uniforms;
+    std::unordered_map<std::string, int> uniformIndex; // name -> index into 'uniforms'
+    DrawUniforms drawHandles;
+    static inline Shader* active = nullptr;
+
+    // Record an upload of 'size' bytes; false if the uniform already holds exactly that value
+    bool changed(UniformHandle handle, const void* data, size_t size) const {
+        if (!handle.valid()) return false;
+        Uniform& uniform = uniforms[handle.index];
+        if (std::memcmp(uniform.value, data, size) == 0) {
+            FrameStats::Instance().RecordUniformUpload(false);
+            return false;
+        }
+        std::memcpy(uniform.value, data, size);
+        FrameStats::Instance().RecordUniformUpload(true);
+        return true;
+    }
+
+    // Build the uniform table from the linked program. Arrays get one entry per element
+    // ("groundTex[1]"), and the bare array name refers to element 0.
+    void reflectUniforms() {
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        std::vector<char> buffer((size_t)std::max(maxLength, 1));
+
+        for (GLint i = 0; i < count; ++i) {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(ID, (GLuint)i, (GLsizei)buffer.size(), &length, &size, &type, buffer.data());
+            std::string name(buffer.data(), (size_t)length);
+
+            // Array names end in "[0]"
+            std::string base = name;
+            bool isArray = base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0;
+            if (isArray) base.erase(base.size() - 3);
+            for (GLint element = 0; element < size; ++element) {
+                std::string elementName = isArray ? base + "[" + std::to_string(element) + "]" : name;
+                GLint location = glGetUniformLocation(ID, elementName.c_str());
+                if (location == -1) continue; // uniform block members have no location
+                uniformIndex[elementName] = (int)uniforms.size();
+                if (isArray && element == 0) uniformIndex[base] = (int)uniforms.size();
+                Uniform uniform = {};
+                uniform.location = location;
+                uniforms.push_back(uniform);
+            }
+        }
+        // Every uniform starts at zero after linking, which is what the shadows hold
+    }
+
     void checkCompileErrors(unsigned int shader, std::string type) {
         int success;
         char infoLog[1024];
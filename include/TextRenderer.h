@@ -5,181 +5,396 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
-#include <ft2build.h>
-#include FT_FREETYPE_H
 #include "Shader.h"
+#include "RenderState.h"
+#include "FrameStats.h"
+#include "GlyphCache.h"
+#include "Utf8.h"
+
+#ifdef TURTLE_HAS_HARFBUZZ
+#include <hb.h>
+#include <hb-ft.h>
+#endif
 
 #include <string>
+#include <string_view>
 #include <iostream>
-#include <map>
 #include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
 
-struct Character {
-    unsigned int TextureID;
-    glm::ivec2   Size;
-    glm::ivec2   Bearing;
-    unsigned int Advance;
+// One corner of a glyph quad in the batch
+struct TextVertex {
+    glm::vec2 position; // pixels from the top-left corner (FrameData::screenProjection)
+    glm::vec2 texCoords;
+    glm::vec4 color;
 };
 
+// Screen text from a single glyph atlas (GlyphCache). Strings are UTF-8; glyphs are rasterized
+// the first time they're used, by default as signed distance fields (see SdfGenerator) that
+// the text shader thresholds, so every scale is drawn sharp from one set.
+//
+// Strings are shaped before layout. With HarfBuzz (TURTLE_HAS_HARFBUZZ, set by CMake when the
+// package is found) every run of one font goes through hb_shape, which handles Thai mark
+// stacking and kerning properly. Without it a simple fallback applies the font's kerning and
+// sets combining marks over their base character, which is enough for Thai in fonts whose marks
+// are zero-width.
+//
+// RenderText() only appends quads to a CPU-side batch, and Flush() uploads the
+// batch into one dynamic vertex buffer and draws all of it with a single call. Colour is a
+// vertex attribute, so differently coloured strings still share the draw.
+//
+// Text that stays the same for many frames goes through TextLabel instead, which keeps its
+// quads in a GPU buffer between frames (see below).
+//
+// Call Flush() once per frame after the last RenderText() / TextLabel::Draw(), with blending enabled.
+class TextLabel;
+
 class TextRenderer {
 public:
-    std::map<GLchar, Character> Characters;
     unsigned int VAO, VBO;
     Shader* shader;
-    
-    TextRenderer(unsigned int width, unsigned int height) {
+
+    TextRenderer(unsigned int width, unsigned int height, GlyphMode mode = GlyphMode::Sdf) : VAO(0), VBO(0), glyphs(mode) {
         shader = new Shader("shaders/text_vertex.glsl", "shaders/text_fragment.glsl");
-        
-        FT_Library ft;
-        if (FT_Init_FreeType(&ft)) {
-            std::cerr << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
+        shader->use();
+        shader->setBool("sdf", mode == GlyphMode::Sdf);
+
+#ifdef TURTLE_HAS_HARFBUZZ
+        hbBuffer = hb_buffer_create();
+        for (int face = 0; face < glyphs.FaceCount(); ++face) hbFonts.push_back(hb_ft_font_create_referenced(glyphs.Face(face)));
+#endif
+
+        // Configure VAO/VBO for the glyph batch; storage is (re)allocated by Flush()
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        setupVertexArray(VAO, VBO);
+
+        // Retained label quads live in their own buffer, allocated on first use
+        glGenVertexArrays(1, &labelVAO);
+    }
+
+    ~TextRenderer() {
+#ifdef TURTLE_HAS_HARFBUZZ
+        for (hb_font_t* font : hbFonts) hb_font_destroy(font);
+        if (hbBuffer) hb_buffer_destroy(hbBuffer);
+#endif
+        if (VAO) glDeleteVertexArrays(1, &VAO);
+        if (VBO) glDeleteBuffers(1, &VBO);
+        if (labelVAO) glDeleteVertexArrays(1, &labelVAO);
+        if (labelVBO) glDeleteBuffers(1, &labelVBO);
+        if (shader) delete shader;
+    }
+
+    // Queue 'text' for this frame's batch. Position is in pixels from the top-left corner
+    // (FrameData::screenProjection); nothing is drawn until Flush().
+    void RenderText(const std::string& text, float x, float y, float scale, glm::vec3 color) {
+        Layout(text, x, y, scale, color, batch);
+    }
+
+    // Append the quads for 'text' (UTF-8) to 'out', and the glyphs they use to 'keys' if given.
+    // Returns false if some glyph couldn't get an atlas cell this frame and was left out.
+    bool Layout(std::string_view text, float x, float y, float scale, const glm::vec3& color, std::vector<TextVertex>& out,
+                std::vector<uint32_t>* keys = nullptr) {
+        if (!glyphs.Valid()) return true;
+        glm::vec4 rgba(color, 1.0f);
+        shape(text);
+        bool complete = true;
+        for (const ShapedGlyph& glyph : shaped) {
+            const Character* found = glyph.character;
+            if (!found) complete = false;
+            if (found && found->Size.x > 0.0f && found->Size.y > 0.0f) {
+                const Character& ch = *found;
+                float xpos = x + (glyph.offset.x + ch.Bearing.x) * scale;
+                float ypos = y - (ch.Size.y - ch.Bearing.y + glyph.offset.y) * scale;
+
+                float w = ch.Size.x * scale;
+                float h = ch.Size.y * scale;
+
+                // Bitmap rows run top-down, so the top edge (smaller y) takes UVMin.y
+                TextVertex quad[6] = {
+                    { { xpos,     ypos + h }, { ch.UVMin.x, ch.UVMax.y }, rgba },
+                    { { xpos,     ypos     }, { ch.UVMin.x, ch.UVMin.y }, rgba },
+                    { { xpos + w, ypos     }, { ch.UVMax.x, ch.UVMin.y }, rgba },
+
+                    { { xpos,     ypos + h }, { ch.UVMin.x, ch.UVMax.y }, rgba },
+                    { { xpos + w, ypos     }, { ch.UVMax.x, ch.UVMin.y }, rgba },
+                    { { xpos + w, ypos + h }, { ch.UVMax.x, ch.UVMax.y }, rgba },
+                };
+                out.insert(out.end(), std::begin(quad), std::end(quad));
+                if (keys) keys->push_back(glyph.key);
+            }
+
+            // Now advance cursors for next glyph
+            x += glyph.advance * scale;
+        }
+        return complete;
+    }
+
+    // Draw everything queued since the last Flush(): retained labels with one multi-draw from
+    // their buffer, then the immediate batch with one draw
+    void Flush() {
+        if (batch.empty() && labelFirsts.empty()) {
+            glyphs.EndFrame();
             return;
         }
 
-        // Load font - try multiple locations
-        FT_Face face;
-        std::vector<std::string> fontPaths = {
-            "C:/Windows/Fonts/arial.ttf",
-            "C:\\Windows\\Fonts\\arial.ttf",
-            "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf"
-        };
-        
-        bool fontLoaded = false;
-        for (const auto& fontPath : fontPaths) {
-            if (FT_New_Face(ft, fontPath.c_str(), 0, &face) == 0) {
-                std::cout << "Loaded font from: " << fontPath << std::endl;
-                fontLoaded = true;
-                break;
-            }
+        RenderState& state = RenderState::Instance();
+        shader->use();
+        state.BindTexture(0, GL_TEXTURE_2D, glyphs.Texture());
+
+        if (!labelFirsts.empty()) {
+            state.BindVertexArray(labelVAO);
+            glMultiDrawArrays(GL_TRIANGLES, labelFirsts.data(), labelCounts.data(), (GLsizei)labelFirsts.size());
+            unsigned int glyphs = 0;
+            for (GLsizei count : labelCounts) glyphs += (unsigned int)count / 6;
+            FrameStats::Instance().RecordTextDraw(glyphs);
+            labelFirsts.clear();
+            labelCounts.clear();
         }
-        
-        if (!fontLoaded) {
-            std::cerr << "ERROR::FREETYPE: Failed to load font from any location" << std::endl;
-            FT_Done_FreeType(ft);
+        if (batch.empty()) {
+            glyphs.EndFrame();
             return;
         }
 
-        // Set size to load glyphs as (size in 1/64th of a point, 48*64 = 3072)
-        FT_Set_Pixel_Sizes(face, 0, 48);
+        state.BindVertexArray(VAO);
 
-        // Disable byte-alignment restriction
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        // Orphan the old storage each frame so the driver doesn't stall on last frame's draw
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        capacity = std::max(capacity, batch.size());
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(TextVertex), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, batch.size() * sizeof(TextVertex), batch.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-        // Load first 128 characters of ASCII set
-        for (unsigned char c = 0; c < 128; c++) {
-            if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-                std::cerr << "ERROR::FREETYTPE: Failed to load Glyph " << (int)c << std::endl;
-                continue;
-            }
+        glDrawArrays(GL_TRIANGLES, 0, (GLsizei)batch.size());
+        FrameStats::Instance().RecordTextDraw((unsigned int)(batch.size() / 6));
+        batch.clear();
+        glyphs.EndFrame();
+    }
 
-            // Generate texture
-            unsigned int texture;
-            glGenTextures(1, &texture);
-            glBindTexture(GL_TEXTURE_2D, texture);
-            glTexImage2D(
-                GL_TEXTURE_2D,
-                0,
-                GL_RED,
-                face->glyph->bitmap.width,
-                face->glyph->bitmap.rows,
-                0,
-                GL_RED,
-                GL_UNSIGNED_BYTE,
-                face->glyph->bitmap.buffer
-            );
-
-            // Set texture options
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-            // Now store character for later use
-            Character character = {
-                texture,
-                glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-                glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-                static_cast<unsigned int>(face->glyph->advance.x)
-            };
-            Characters.insert(std::pair<char, Character>(c, character));
-        }
+private:
+    friend class TextLabel;
 
-        glBindTexture(GL_TEXTURE_2D, 0);
+    // A glyph ready for layout; 'advance' and 'offset' are nominal pixels, offset y up
+    struct ShapedGlyph {
+        uint32_t key;
+        const Character* character; // nullptr: nothing to draw this frame
+        float advance;
+        glm::vec2 offset;
+    };
 
-        std::cout << "Loaded " << Characters.size() << " glyphs from font" << std::endl;
+    GlyphCache glyphs;
+    std::vector<char32_t> codepoints; // shaping scratch, reused between strings
+    std::vector<ShapedGlyph> shaped;
+#ifdef TURTLE_HAS_HARFBUZZ
+    hb_buffer_t* hbBuffer = nullptr;
+    std::vector<hb_font_t*> hbFonts; // one per GlyphCache face
+#endif
 
-        // Destroy FreeType once we're finished
-        FT_Done_Face(face);
-        FT_Done_FreeType(ft);
+    std::vector<TextVertex> batch;
+    size_t capacity = 0; // vertices the buffer was last sized for
 
-        // Configure VAO/VBO for texture quads
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
+    // Retained label storage: each TextLabel owns a slot of 'labelVBO'; slots are handed out
+    // front to back and never reused (labels are few and live for the whole game)
+    GLuint labelVAO = 0;
+    GLuint labelVBO = 0;
+    size_t labelCapacity = 0; // vertices
+    size_t labelUsed = 0;
+    std::vector<GLint> labelFirsts;   // this frame's label draws, for glMultiDrawArrays
+    std::vector<GLsizei> labelCounts;
+
+    static void setupVertexArray(GLuint vao, GLuint vbo) {
+        RenderState::Instance().BindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
         glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, position));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, texCoords));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, color));
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+        RenderState::Instance().BindVertexArray(0);
     }
 
-    ~TextRenderer() {
-        for (auto& p : Characters) {
-            glDeleteTextures(1, &p.second.TextureID);
+    // Reserve 'vertices' in the label buffer and return the first one. A full buffer is
+    // replaced by one twice the size, with the existing slots copied over on the GPU.
+    size_t allocateLabelSlot(size_t vertices) {
+        if (labelUsed + vertices > labelCapacity) {
+            size_t newCapacity = std::max(labelCapacity * 2, labelUsed + vertices);
+            GLuint newVBO = 0;
+            glGenBuffers(1, &newVBO);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, newVBO);
+            glBufferData(GL_COPY_WRITE_BUFFER, newCapacity * sizeof(TextVertex), nullptr, GL_DYNAMIC_DRAW);
+            if (labelVBO != 0) {
+                glBindBuffer(GL_COPY_READ_BUFFER, labelVBO);
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, labelUsed * sizeof(TextVertex));
+                glBindBuffer(GL_COPY_READ_BUFFER, 0);
+                glDeleteBuffers(1, &labelVBO);
+            }
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            labelVBO = newVBO;
+            labelCapacity = newCapacity;
+            setupVertexArray(labelVAO, labelVBO);
         }
-        if (VAO) glDeleteVertexArrays(1, &VAO);
-        if (VBO) glDeleteBuffers(1, &VBO);
-        if (shader) delete shader;
+        size_t first = labelUsed;
+        labelUsed += vertices;
+        return first;
     }
 
-    void RenderText(std::string text, float x, float y, float scale, glm::vec3 color, unsigned int screenWidth, unsigned int screenHeight) {
-        shader->use();
-        glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(screenWidth), static_cast<float>(screenHeight), 0.0f, -1.0f, 1.0f);
-        shader->setMat4("projection", projection);
-        shader->setVec3("textColor", color);
-        glActiveTexture(GL_TEXTURE0);
-        glBindVertexArray(VAO);
-
-        // Iterate through all characters
-        for (auto c : text) {
-            if (Characters.find(c) == Characters.end()) continue;
-            
-            Character ch = Characters[c];
-
-            float xpos = x + ch.Bearing.x * scale;
-            float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
-
-            float w = ch.Size.x * scale;
-            float h = ch.Size.y * scale;
-
-            // Update VBO for each character - FIX: Flip UV coordinates
-            float vertices[6][4] = {
-                { xpos,     ypos + h,   0.0f, 1.0f },            
-                { xpos,     ypos,       0.0f, 0.0f },
-                { xpos + w, ypos,       1.0f, 0.0f },
-
-                { xpos,     ypos + h,   0.0f, 1.0f },
-                { xpos + w, ypos,       1.0f, 0.0f },
-                { xpos + w, ypos + h,   1.0f, 1.0f }           
-            };
-
-            // Render glyph texture over quad
-            glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-
-            // Update content of VBO memory
-            glBindBuffer(GL_ARRAY_BUFFER, VBO);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-            // Render quad
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-
-            // Now advance cursors for next glyph (note that advance is number of 1/64 pixels)
-            x += (ch.Advance >> 6) * scale;
+    void uploadLabel(size_t first, const std::vector<TextVertex>& vertices) {
+        glBindBuffer(GL_ARRAY_BUFFER, labelVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(TextVertex), vertices.size() * sizeof(TextVertex), vertices.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void queueLabel(size_t first, size_t count) {
+        labelFirsts.push_back((GLint)first);
+        labelCounts.push_back((GLsizei)count);
+    }
+
+    // Marks drawn over or under the previous character rather than after it
+    static bool isCombiningMark(char32_t c) {
+        return (c >= 0x0300 && c <= 0x036F) ||                   // combining diacritics
+               c == 0x0E31 || (c >= 0x0E34 && c <= 0x0E3A) ||    // Thai vowels above / below
+               (c >= 0x0E47 && c <= 0x0E4E);                      // Thai tone marks and signs
+    }
+
+    // Decode 'text' and turn it into positioned glyphs in 'shaped', one run per font
+    void shape(std::string_view text) {
+        codepoints.clear();
+        shaped.clear();
+        Utf8::Decode(text, codepoints);
+
+        size_t runStart = 0;
+        int runFace = -1;
+        for (size_t i = 0; i <= codepoints.size(); ++i) {
+            int face = -1;
+            if (i < codepoints.size()) {
+                char32_t c = codepoints[i];
+                face = glyphs.FaceFor(c, isCombiningMark(c) ? runFace : -1);
+                if (face == runFace) continue;
+            }
+            if (runFace >= 0) shapeRun(runFace, runStart, i);
+            runStart = i;
+            runFace = face;
+        }
+    }
+
+#ifdef TURTLE_HAS_HARFBUZZ
+    void shapeRun(int face, size_t begin, size_t end) {
+        hb_buffer_clear_contents(hbBuffer);
+        hb_buffer_add_utf32(hbBuffer, reinterpret_cast<const uint32_t*>(codepoints.data()) + begin, (int)(end - begin), 0, (int)(end - begin));
+        hb_buffer_guess_segment_properties(hbBuffer);
+        hb_shape(hbFonts[face], hbBuffer, nullptr, 0);
+
+        unsigned int count = 0;
+        const hb_glyph_info_t* infos = hb_buffer_get_glyph_infos(hbBuffer, &count);
+        const hb_glyph_position_t* positions = hb_buffer_get_glyph_positions(hbBuffer, &count);
+        for (unsigned int i = 0; i < count; ++i) {
+            uint32_t key = GlyphCache::Key(face, infos[i].codepoint);
+            shaped.push_back({ key, glyphs.Acquire(key), glyphs.FromFontUnits(positions[i].x_advance),
+                               glm::vec2(glyphs.FromFontUnits(positions[i].x_offset), glyphs.FromFontUnits(positions[i].y_offset)) });
+        }
+    }
+#else
+    void shapeRun(int face, size_t begin, size_t end) {
+        FT_Face ftFace = glyphs.Face(face);
+        FT_UInt previous = 0;
+        for (size_t i = begin; i < end; ++i) {
+            FT_UInt glyphIndex = FT_Get_Char_Index(ftFace, codepoints[i]);
+            uint32_t key = GlyphCache::Key(face, glyphIndex);
+            const Character* character = glyphs.Acquire(key);
+            ShapedGlyph glyph = { key, character, character ? character->Advance : 0.0f, glm::vec2(0.0f) };
+
+            if (isCombiningMark(codepoints[i]) && !shaped.empty()) {
+                // Centre a spacing mark over its base; zero-width marks are already placed by the font
+                if (glyph.advance > 0.0f) glyph.offset.x = -(shaped.back().advance + glyph.advance) * 0.5f;
+                glyph.advance = 0.0f;
+            } else if (previous != 0 && FT_HAS_KERNING(ftFace)) {
+                FT_Vector kerning;
+                if (FT_Get_Kerning(ftFace, previous, glyphIndex, FT_KERNING_UNFITTED, &kerning) == 0) {
+                    shaped.back().advance += glyphs.FromFontUnits(kerning.x);
+                }
+            }
+            if (!isCombiningMark(codepoints[i])) previous = glyphIndex;
+            shaped.push_back(glyph);
+        }
+    }
+#endif
+};
+
+// A piece of screen text kept laid out between frames. Set() compares the new text, position,
+// scale and colour against the current ones and only re-lays out and re-uploads the quads
+// when something changed; Draw() just queues the label's range of the retained buffer for
+// TextRenderer::Flush(). Once the label's storage has grown to its longest text, neither
+// call allocates.
+//
+// The label pins its glyphs in the atlas while it holds them, so its cached quads never point
+// at reused cells and Draw() does no per-glyph work. Only a label that was missing glyphs
+// (the atlas was full) lays out again on Draw(), once the atlas has evicted something.
+class TextLabel {
+public:
+    explicit TextLabel(TextRenderer& renderer) : renderer(&renderer) {}
+
+    TextLabel(std::string_view text, float x, float y, float scale, const glm::vec3& color, TextRenderer& renderer)
+        : renderer(&renderer) {
+        Set(text, x, y, scale, color);
+    }
+
+    ~TextLabel() {
+        for (uint32_t key : keys) renderer->glyphs.Unpin(key);
+    }
+
+    TextLabel(const TextLabel&) = delete;
+    TextLabel& operator=(const TextLabel&) = delete;
+
+    void Set(std::string_view newText, float newX, float newY, float newScale, const glm::vec3& newColor) {
+        if (laidOut && newText == text && newX == x && newY == y && newScale == scale && newColor == color) return;
+
+        text.assign(newText.data(), newText.size());
+        x = newX;
+        y = newY;
+        scale = newScale;
+        color = newColor;
+        laidOut = true;
+        layout();
+    }
+
+    void Draw() {
+        if (!complete && generation != renderer->glyphs.Generation()) layout();
+        if (!vertices.empty()) renderer->queueLabel(slotFirst, vertices.size());
+    }
+
+    const std::string& Text() const { return text; }
+
+private:
+    TextRenderer* renderer;
+    std::string text;
+    float x = 0.0f, y = 0.0f, scale = 1.0f;
+    glm::vec3 color = glm::vec3(1.0f);
+    bool laidOut = false;
+    std::vector<TextVertex> vertices; // CPU copy, reused so re-layout doesn't allocate
+    std::vector<uint32_t> keys;       // GlyphCache keys of the glyphs in 'vertices', pinned
+    bool complete = true;             // every glyph got a cell at layout
+    uint64_t generation = 0;          // GlyphCache::Generation() at layout
+    size_t slotFirst = 0;             // first vertex of this label's slot in the retained buffer
+    size_t slotCapacity = 0;          // vertices the slot can hold
+
+    void layout() {
+        for (uint32_t key : keys) renderer->glyphs.Unpin(key);
+        vertices.clear();
+        keys.clear();
+        complete = renderer->Layout(text, x, y, scale, color, vertices, &keys);
+        for (uint32_t key : keys) renderer->glyphs.Pin(key);
+        generation = renderer->glyphs.Generation();
+        if (vertices.size() > slotCapacity) {
+            // Round up so a label whose text grows by a character or two keeps its new slot
+            slotCapacity = 6 * 16;
+            while (slotCapacity < vertices.size()) slotCapacity *= 2;
+            slotFirst = renderer->allocateLabelSlot(slotCapacity);
         }
-        glBindVertexArray(0);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        if (!vertices.empty()) renderer->uploadLabel(slotFirst, vertices);
     }
 };
 
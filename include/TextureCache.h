@@ -0,0 +1,508 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <glad/glad.h>
+#include "ImageLoader.h"
+#include "BlockCompression.h"
+#include "MipGenerator.h"
+#include "RenderState.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <mutex>
+#include <filesystem>
+#include <iostream>
+#include <cstring>
+
+// S3TC is an extension and BPTC core only from GL 4.2, so a 3.3 core loader may not define these
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+
+// Sampler settings are part of the cache key: the same image with different
+// wrap/filter modes needs its own texture object
+struct SamplerDesc {
+    GLenum wrapS = GL_REPEAT;
+    GLenum wrapT = GL_REPEAT;
+    GLenum minFilter = GL_LINEAR_MIPMAP_LINEAR;
+    GLenum magFilter = GL_LINEAR;
+    bool mipmaps = true;
+
+    static SamplerDesc Repeat() { return SamplerDesc(); }
+
+    static SamplerDesc ClampLinear() {
+        SamplerDesc s;
+        s.wrapS = GL_CLAMP_TO_EDGE;
+        s.wrapT = GL_CLAMP_TO_EDGE;
+        s.minFilter = GL_LINEAR;
+        s.mipmaps = false;
+        return s;
+    }
+
+    std::string key() const {
+        return std::to_string(wrapS) + "," + std::to_string(wrapT) + "," +
+               std::to_string(minFilter) + "," + std::to_string(magFilter) + "," +
+               (mipmaps ? "m" : "-");
+    }
+};
+
+// GPU texture owned through shared handles; deleted when the last handle goes away
+struct Texture {
+    unsigned int id = 0;
+    GLenum target = GL_TEXTURE_2D;
+    int width = 0;
+    int height = 0;
+    size_t bytes = 0; // estimated GPU memory including mip chain
+
+    Texture() = default;
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+
+    ~Texture() {
+        if (id != 0) glDeleteTextures(1, &id);
+    }
+};
+
+using TextureHandle = std::shared_ptr<Texture>;
+
+// Decoder callback: fill 'out' from the file at 'path', return false on failure
+using ImageDecoder = std::function<bool(const std::string& path, ImageData& out)>;
+
+// Images decoded ahead of time (e.g. on an AssetLoader worker), keyed by the path they came from
+using DecodedImages = std::unordered_map<std::string, ImageData>;
+
+// Process-wide texture cache keyed by canonical path + sampler settings.
+// A hit returns the existing texture without touching the disk. Acquire* are main-thread only;
+// Contains() may be called from any thread, so loaders can skip decoding what is cached.
+class TextureCache {
+public:
+    struct Stats {
+        unsigned int hits = 0;
+        unsigned int misses = 0;
+        unsigned int failures = 0;
+        size_t bytesDecoded = 0;   // CPU bytes produced by decoders
+        size_t bytesUploaded = 0;  // estimated GPU bytes allocated
+        size_t bytesSaved = 0;     // GPU bytes that hits did not allocate again
+        unsigned int prebuiltMips = 0; // uploads that used a baked mip chain instead of glGenerateMipmap
+        unsigned int compressed = 0;   // uploads kept block-compressed on the GPU
+        unsigned int transcoded = 0;   // block-compressed images expanded to RGBA for lack of GPU support
+        size_t bytesSavedByCompression = 0; // GPU bytes saved against RGBA8
+    };
+
+    static TextureCache& Instance() {
+        static TextureCache instance;
+        return instance;
+    }
+
+    // Return a shared 2D texture for 'path', decoding and uploading it only on a miss.
+    // Returns nullptr if the decoder fails.
+    TextureHandle Acquire(const std::string& path, const SamplerDesc& sampler, const ImageDecoder& decode) {
+        std::string key = Key(path, sampler);
+        if (TextureHandle existing = Find(key)) return existing;
+
+        ImageData image;
+        if (!decode(path, image) || !image.valid()) {
+            stats.failures++;
+            return nullptr;
+        }
+        stats.bytesDecoded += image.pixels.size();
+
+        TextureHandle texture = Upload2D(image, sampler);
+        Insert(key, texture);
+        size_t levels = sampler.mipmaps ? image.mips.size() + 1 : 1;
+        reportCompression(path, image.block, Rgba8Bytes(image, levels), texture->bytes);
+        return texture;
+    }
+
+    // Return a shared cube map built from six face images (+X, -X, +Y, -Y, +Z, -Z)
+    TextureHandle AcquireCubemap(const std::vector<std::string>& faces, const ImageDecoder& decode) {
+        std::string key = CubemapKey(faces);
+        if (TextureHandle existing = Find(key)) return existing;
+
+        std::vector<ImageData> images(faces.size());
+        for (size_t i = 0; i < faces.size(); ++i) {
+            if (!decode(faces[i], images[i]) || !images[i].valid()) {
+                std::cerr << "Failed to load cubemap face: " << faces[i] << std::endl;
+                stats.failures++;
+                return nullptr;
+            }
+            stats.bytesDecoded += images[i].pixels.size();
+        }
+
+        TextureHandle texture = UploadCubemap(images);
+        Insert(key, texture);
+        if (!images.empty()) reportCompression("cubemap", images[0].block, Rgba8Bytes(images[0], 1) * images.size(), texture->bytes);
+        return texture;
+    }
+
+    // Return a shared GL_TEXTURE_2D_ARRAY with one layer per image in 'layers', in order.
+    // Layers baked as a set (see LayersMatch) are uploaded as-is, block-compressed levels
+    // included; any others are brought to a common RGBA8 size first (see NormalizeLayers) and
+    // get their mipmaps generated on the GPU. 'name' identifies the array in the cache.
+    TextureHandle AcquireArray(const std::string& name, const std::vector<std::string>& layers,
+                               const SamplerDesc& sampler, const ImageDecoder& decode) {
+        std::string key = ArrayKey(name, sampler);
+        if (TextureHandle existing = Find(key)) return existing;
+
+        std::vector<ImageData> images(layers.size());
+        for (size_t i = 0; i < layers.size(); ++i) {
+            if (!decode(layers[i], images[i]) || !images[i].valid()) {
+                std::cerr << "Failed to load texture array layer: " << layers[i] << std::endl;
+                stats.failures++;
+                return nullptr;
+            }
+            stats.bytesDecoded += images[i].pixels.size();
+        }
+        if (images.empty()) return nullptr;
+
+        if (!LayersMatch(images)) NormalizeLayers(images);
+        TextureHandle texture = UploadArray(images, sampler);
+        Insert(key, texture);
+        size_t levels = sampler.mipmaps ? images[0].mips.size() + 1 : 1;
+        reportCompression(name, images[0].block, Rgba8Bytes(images[0], levels) * images.size(), texture->bytes);
+        return texture;
+    }
+
+    // Cache keys of Acquire, AcquireCubemap and AcquireArray
+    static std::string Key(const std::string& path, const SamplerDesc& sampler) {
+        return CanonicalPath(path) + "|" + sampler.key();
+    }
+
+    static std::string CubemapKey(const std::vector<std::string>& faces) {
+        std::string key = "cubemap";
+        for (const auto& face : faces) key += "|" + CanonicalPath(face);
+        return key;
+    }
+
+    static std::string ArrayKey(const std::string& name, const SamplerDesc& sampler) {
+        return "array|" + name + "|" + sampler.key();
+    }
+
+    // True if a live texture is cached under 'key'. Thread-safe. The texture can still be
+    // released before the caller acquires it, so keep a way to decode on a miss.
+    bool Contains(const std::string& key) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = textures.find(key);
+        return it != textures.end() && !it->second.expired();
+    }
+
+    // True if 'layers' can go into one array without conversion: same size, pixel or block
+    // format and number of mip levels, as asset_baker writes the ground layers
+    static bool LayersMatch(const std::vector<ImageData>& layers) {
+        for (const ImageData& image : layers) {
+            const ImageData& first = layers.front();
+            if (image.width != first.width || image.height != first.height || image.channels != first.channels ||
+                image.block != first.block || image.mips.size() != first.mips.size()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Fallback for layers that weren't baked as a set: block-compressed images are
+    // decompressed, every layer is expanded to RGBA and resampled to the largest width and
+    // height among them, and baked mips are dropped. CPU only, so a loader thread can do it.
+    static void NormalizeLayers(std::vector<ImageData>& layers) {
+        int width = 0, height = 0;
+        for (const ImageData& image : layers) {
+            width = std::max(width, image.width);
+            height = std::max(height, image.height);
+        }
+        for (ImageData& image : layers) {
+            BlockCompression::Decompress(image);
+            image.mips.clear();
+            if (image.channels != 4) {
+                std::vector<unsigned char> rgba((size_t)image.width * image.height * 4);
+                for (size_t i = 0, texels = (size_t)image.width * image.height; i < texels; ++i) {
+                    const unsigned char* in = &image.pixels[i * image.channels];
+                    unsigned char* out = &rgba[i * 4];
+                    out[0] = in[0];
+                    out[1] = image.channels >= 3 ? in[1] : in[0];
+                    out[2] = image.channels >= 3 ? in[2] : in[0];
+                    out[3] = image.channels == 2 ? in[1] : 255;
+                }
+                image.pixels.swap(rgba);
+                image.channels = 4;
+            }
+            MipGenerator::Resize(image, width, height);
+        }
+    }
+
+    const Stats& GetStats() const { return stats; }
+
+    void PrintStats() const {
+        std::cout << "TextureCache: " << stats.hits << " hits, " << stats.misses << " misses, "
+                  << stats.failures << " failures, "
+                  << stats.bytesDecoded / 1024 << " KB decoded, "
+                  << stats.bytesUploaded / 1024 << " KB uploaded, "
+                  << stats.bytesSaved / 1024 << " KB saved by sharing, "
+                  << stats.prebuiltMips << " with baked mips, "
+                  << stats.compressed << " block-compressed (" << stats.bytesSavedByCompression / 1024 << " KB saved), "
+                  << stats.transcoded << " transcoded on the CPU" << std::endl;
+    }
+
+    static std::string CanonicalPath(const std::string& path) {
+        std::error_code ec;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(path, ec);
+        if (ec) canonical = std::filesystem::path(path).lexically_normal();
+        return canonical.generic_string();
+    }
+
+    // Decoder that hands out images from 'images' instead of reading the disk; each image is
+    // moved out on use. Paths missing from 'images' (skipped because the cache held them) go to
+    // 'fallback' if given. 'images' must outlive the Acquire call the decoder is passed to.
+    static ImageDecoder FromDecoded(DecodedImages& images, ImageDecoder fallback = nullptr) {
+        DecodedImages* source = &images;
+        return [source, fallback](const std::string& path, ImageData& out) {
+            auto it = source->find(path);
+            if (it == source->end()) return fallback ? fallback(path, out) : false;
+            if (!it->second.valid()) return false;
+            out = std::move(it->second);
+            source->erase(it);
+            return true;
+        };
+    }
+
+    // Query which block formats the current GL context samples natively. Call once on the main
+    // thread after the GL loader is initialised; until then every compressed image is
+    // transcoded to RGBA.
+    static void DetectCompressionSupport() {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        bool s3tc = false, bptc = false;
+        for (GLint i = 0; i < count; ++i) {
+            const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, (GLuint)i));
+            if (!name) continue;
+            if (std::strcmp(name, "GL_EXT_texture_compression_s3tc") == 0) s3tc = true;
+            if (std::strcmp(name, "GL_ARB_texture_compression_bptc") == 0) bptc = true;
+        }
+        BlockCompression::SupportsS3tc = s3tc;
+        BlockCompression::SupportsBptc = bptc;
+        std::cout << "Texture compression: BC1/BC3 " << (s3tc ? "yes" : "no (CPU transcode)")
+                  << ", BC7 " << (bptc ? "yes" : "no (CPU transcode)") << std::endl;
+    }
+
+    static GLenum CompressedFormat(BlockFormat format) {
+        if (format == BlockFormat::BC1) return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        if (format == BlockFormat::BC3) return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    }
+
+    static GLenum FormatForChannels(int channels) {
+        if (channels == 1) return GL_RED;
+        if (channels == 2) return GL_RG;
+        if (channels == 3) return GL_RGB;
+        return GL_RGBA;
+    }
+
+private:
+    TextureCache() = default;
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    TextureHandle Find(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = textures.find(key);
+        if (it != textures.end()) {
+            if (TextureHandle existing = it->second.lock()) {
+                stats.hits++;
+                stats.bytesSaved += existing->bytes;
+                return existing;
+            }
+        }
+        return nullptr;
+    }
+
+    void Insert(const std::string& key, const TextureHandle& texture) {
+        stats.misses++;
+        stats.bytesUploaded += texture->bytes;
+        std::lock_guard<std::mutex> lock(mutex);
+        textures[key] = texture;
+    }
+
+    static size_t EstimateBytes(const ImageData& image, bool mipmaps) {
+        size_t base = (size_t)image.width * image.height * image.channels;
+        return mipmaps ? base * 4 / 3 : base;
+    }
+
+    // Block-compressed images the GPU can't sample become RGBA before upload. Normally the
+    // loader thread has done this already (BakedTexture::Decode).
+    void ensureUploadable(ImageData& image) {
+        if (image.block == BlockFormat::None || BlockCompression::GpuSupports(image.block)) return;
+        BlockCompression::Decompress(image);
+        stats.transcoded++;
+    }
+
+    // Upload one level, compressed or raw; returns its GPU size in bytes
+    static size_t UploadLevel(GLenum target, int level, const ImageData& image, const std::vector<unsigned char>& data) {
+        int width = ImageData::MipSize(image.width, level);
+        int height = ImageData::MipSize(image.height, level);
+        if (image.block != BlockFormat::None) {
+            glCompressedTexImage2D(target, level, CompressedFormat(image.block), width, height, 0,
+                                   (GLsizei)data.size(), data.data());
+        } else {
+            GLenum format = FormatForChannels(image.channels);
+            glTexImage2D(target, level, format, width, height, 0, format, GL_UNSIGNED_BYTE, data.data());
+        }
+        return data.size();
+    }
+
+    // RGBA8 size of the levels the texture will have, the baseline for compression savings
+    static size_t Rgba8Bytes(const ImageData& image, size_t levels) {
+        size_t bytes = 0;
+        for (size_t level = 0; level < levels; ++level) {
+            bytes += (size_t)ImageData::MipSize(image.width, (int)level) * ImageData::MipSize(image.height, (int)level) * 4;
+        }
+        return bytes;
+    }
+
+    // Per-texture VRAM report for textures that stayed block-compressed on the GPU
+    void reportCompression(const std::string& name, BlockFormat block, size_t rgba8Bytes, size_t gpuBytes) {
+        if (block == BlockFormat::None) return;
+        size_t saved = rgba8Bytes > gpuBytes ? rgba8Bytes - gpuBytes : 0;
+        stats.compressed++;
+        stats.bytesSavedByCompression += saved;
+        std::cout << "Compressed texture " << name << ": " << BlockCompression::FormatName(block) << ", "
+                  << gpuBytes / 1024 << " KB (" << saved / 1024 << " KB saved vs RGBA8)" << std::endl;
+    }
+
+    TextureHandle Upload2D(ImageData& image, const SamplerDesc& sampler) {
+        ensureUploadable(image);
+
+        auto texture = std::make_shared<Texture>();
+        texture->target = GL_TEXTURE_2D;
+        texture->width = image.width;
+        texture->height = image.height;
+
+        glGenTextures(1, &texture->id);
+        RenderState::Instance().BindTexture(0, GL_TEXTURE_2D, texture->id);
+        // Decoded rows are tightly packed
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        texture->bytes = UploadLevel(GL_TEXTURE_2D, 0, image, image.pixels);
+        if (sampler.mipmaps && !image.mips.empty()) {
+            // Baked chain: upload every level as filtered offline
+            for (size_t level = 1; level <= image.mips.size(); ++level) {
+                texture->bytes += UploadLevel(GL_TEXTURE_2D, (int)level, image, image.mips[level - 1]);
+            }
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)image.mips.size());
+            stats.prebuiltMips++;
+        } else if (sampler.mipmaps && image.block == BlockFormat::None) {
+            glGenerateMipmap(GL_TEXTURE_2D);
+            texture->bytes = EstimateBytes(image, true);
+        } else {
+            // Level 0 only (GL can't generate mips for compressed data)
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, sampler.wrapS);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, sampler.wrapT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, sampler.minFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, sampler.magFilter);
+        return texture;
+    }
+
+    // Allocate one level of the array and fill it layer by layer, compressed or raw; returns
+    // its GPU size in bytes
+    static size_t UploadArrayLevel(int level, const std::vector<ImageData>& layers) {
+        const ImageData& first = layers[0];
+        int width = ImageData::MipSize(first.width, level);
+        int height = ImageData::MipSize(first.height, level);
+        GLsizei depth = (GLsizei)layers.size();
+        auto levelData = [level](const ImageData& image) -> const std::vector<unsigned char>& {
+            return level == 0 ? image.pixels : image.mips[level - 1];
+        };
+
+        size_t layerBytes = levelData(first).size();
+        if (first.block != BlockFormat::None) {
+            GLenum format = CompressedFormat(first.block);
+            glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, format, width, height, depth, 0,
+                                   (GLsizei)(layerBytes * layers.size()), nullptr);
+            for (size_t i = 0; i < layers.size(); ++i) {
+                glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, (GLint)i, width, height, 1, format,
+                                          (GLsizei)layerBytes, levelData(layers[i]).data());
+            }
+        } else {
+            GLenum format = FormatForChannels(first.channels);
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, format, width, height, depth, 0, format, GL_UNSIGNED_BYTE, nullptr);
+            for (size_t i = 0; i < layers.size(); ++i) {
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, (GLint)i, width, height, 1,
+                                format, GL_UNSIGNED_BYTE, levelData(layers[i]).data());
+            }
+        }
+        return layerBytes * layers.size();
+    }
+
+    // Layers must already share size, format and mip count (LayersMatch)
+    TextureHandle UploadArray(const std::vector<ImageData>& layers, const SamplerDesc& sampler) {
+        const ImageData& first = layers[0];
+        auto texture = std::make_shared<Texture>();
+        texture->target = GL_TEXTURE_2D_ARRAY;
+        texture->width = first.width;
+        texture->height = first.height;
+
+        glGenTextures(1, &texture->id);
+        RenderState::Instance().BindTexture(0, GL_TEXTURE_2D_ARRAY, texture->id);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        texture->bytes = UploadArrayLevel(0, layers);
+        if (sampler.mipmaps && !first.mips.empty()) {
+            // Baked chains: upload every level as filtered offline
+            for (size_t level = 1; level <= first.mips.size(); ++level) {
+                texture->bytes += UploadArrayLevel((int)level, layers);
+            }
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, (GLint)first.mips.size());
+            stats.prebuiltMips++;
+        } else if (sampler.mipmaps && first.block == BlockFormat::None) {
+            glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+            texture->bytes = texture->bytes * 4 / 3;
+        } else {
+            // Level 0 only (GL can't generate mips for compressed data)
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, 0);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, sampler.wrapS);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, sampler.wrapT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, sampler.minFilter);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, sampler.magFilter);
+        return texture;
+    }
+
+    TextureHandle UploadCubemap(std::vector<ImageData>& faces) {
+        auto texture = std::make_shared<Texture>();
+        texture->target = GL_TEXTURE_CUBE_MAP;
+        texture->width = faces.empty() ? 0 : faces[0].width;
+        texture->height = faces.empty() ? 0 : faces[0].height;
+
+        glGenTextures(1, &texture->id);
+        RenderState::Instance().BindTexture(0, GL_TEXTURE_CUBE_MAP, texture->id);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (size_t i = 0; i < faces.size(); ++i) {
+            ensureUploadable(faces[i]);
+            texture->bytes += UploadLevel(GL_TEXTURE_CUBE_MAP_POSITIVE_X + (GLenum)i, 0, faces[i], faces[i].pixels);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        return texture;
+    }
+
+    mutable std::mutex mutex; // guards 'textures' (Contains runs on loader threads)
+    std::unordered_map<std::string, std::weak_ptr<Texture>> textures;
+    Stats stats;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <string_view>
+#include <vector>
+
+namespace Utf8 {
+
+constexpr char32_t Replacement = 0xFFFD;
+
+// Decode 'text' into 'out' (appending). Malformed sequences, overlong forms and surrogates
+// each become one U+FFFD, so any byte string yields something drawable.
+inline void Decode(std::string_view text, std::vector<char32_t>& out) {
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned char lead = (unsigned char)text[i];
+        if (lead < 0x80) {
+            out.push_back(lead);
+            ++i;
+            continue;
+        }
+
+        int length;
+        char32_t codepoint;
+        char32_t minimum;
+        if ((lead & 0xE0) == 0xC0) { length = 2; codepoint = lead & 0x1F; minimum = 0x80; }
+        else if ((lead & 0xF0) == 0xE0) { length = 3; codepoint = lead & 0x0F; minimum = 0x800; }
+        else if ((lead & 0xF8) == 0xF0) { length = 4; codepoint = lead & 0x07; minimum = 0x10000; }
+        else {
+            out.push_back(Replacement);
+            ++i;
+            continue;
+        }
+
+        int read = 1;
+        while (read < length && i + read < text.size() && ((unsigned char)text[i + read] & 0xC0) == 0x80) {
+            codepoint = (codepoint << 6) | ((unsigned char)text[i + read] & 0x3F);
+            ++read;
+        }
+        bool valid = read == length && codepoint >= minimum && codepoint <= 0x10FFFF &&
+                     !(codepoint >= 0xD800 && codepoint <= 0xDFFF);
+        out.push_back(valid ? codepoint : Replacement);
+        i += read;
+    }
+}
+
+} // namespace Utf8
+
+#endif
@@ -0,0 +1,7 @@
+#version 330 core
+
+// Depth pre-pass (RenderQueue::SetDepthPrepass): paired with vertex_shader.glsl, writes only
+// depth so the colour pass shades each visible pixel once
+void main()
+{
+}
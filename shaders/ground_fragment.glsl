@@ -0,0 +1,71 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoords;
+
+// Per-frame camera/lighting/fog state (see FrameData.h)
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 screenProjection; // pixels, origin top-left (text and HUD)
+    vec3 lightPos;   float fogNear;
+    vec3 lightColor; float fogFar;
+    vec3 viewPos;
+    vec3 fogColor;
+};
+
+// Ground layers: 0 grass, 1 lake, 2 street, 3 bridge over the lake (see GroundLayers.h)
+uniform sampler2DArray groundLayers;
+uniform float textureZoneSize; // world-space size of each texture zone (Z axis)
+
+// Ground-only counterpart of fragment_shader.glsl (paired with vertex_shader.glsl): every
+// fragment picks its layer from its world position, without branching
+void main()
+{
+    // Ambient - เพิ่มให้สว่างขึ้น
+    float ambientStrength = 0.6;
+    vec3 ambient = ambientStrength * lightColor;
+
+    // Diffuse
+    vec3 norm = normalize(Normal);
+    vec3 lightDir = normalize(lightPos - FragPos);
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * lightColor;
+
+    // Specular
+    float specularStrength = 0.3;
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
+    vec3 specular = specularStrength * spec * lightColor;
+
+    // Determine which zone this fragment lies in along Z (world space)
+    // We use -FragPos.z because the game uses decreasing Z to move forward
+    float zone = floor(-FragPos.z / textureZoneSize);
+    float layer = mod(zone, 3.0); // 0 grass, 1 lake, 2 street; hard cutoff at zone borders
+
+    // Bridge stripe down the middle of lake zones (where the player walks): 16 units wide,
+    // repeating every 40 units in X. Lake fragments on it move from layer 1 to layer 3.
+    float bridgeWidth = 16.0;
+    float centeredX = mod(FragPos.x + 20.0, 40.0) - 20.0; // [-20, 20)
+    float inLake = 1.0 - min(abs(layer - 1.0), 1.0);
+    float onBridge = 1.0 - step(bridgeWidth * 0.5, abs(centeredX));
+    layer += 2.0 * inLake * onBridge;
+
+    // One fetch per fragment; the bridge layer already has the water blended in
+    vec3 finalColor = texture(groundLayers, vec3(TexCoords, layer)).rgb;
+
+    // Apply lighting to the chosen color
+    vec3 lit = (ambient + diffuse + specular) * finalColor;
+
+    // Apply fog effect
+    float distance = length(FragPos - viewPos);
+    float fogFactor = (fogFar - distance) / (fogFar - fogNear);
+    fogFactor = clamp(fogFactor, 0.0, 1.0);
+
+    vec3 finalLit = mix(fogColor, lit, fogFactor);
+
+    FragColor = vec4(finalLit, 1.0);
+}
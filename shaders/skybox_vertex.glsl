@@ -1,8 +1,16 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 
-uniform mat4 projection;
-uniform mat4 view;
+// Per-frame camera/lighting/fog state (see FrameData.h)
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 screenProjection; // pixels, origin top-left (text and HUD)
+    vec3 lightPos;   float fogNear;
+    vec3 lightColor; float fogFar;
+    vec3 viewPos;
+    vec3 fogColor;
+};
 
 out vec3 TexCoords;
 
@@ -1,12 +1,19 @@
 #version 330 core
 in vec2 TexCoords;
+in vec4 TextColor;
 out vec4 color;
 
-uniform sampler2D text;
-uniform vec3 textColor;
+uniform sampler2D text; // glyph atlas
+uniform bool sdf;       // atlas holds distance fields (0.5 = outline) rather than coverage
 
 void main()
 {    
-    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
-    color = vec4(textColor, 1.0) * sampled;
+    float value = texture(text, TexCoords).r;
+    float alpha = value;
+    if (sdf) {
+        // Antialias over about one screen pixel whatever the text scale
+        float width = max(fwidth(value), 1e-4);
+        alpha = smoothstep(0.5 - width, 0.5 + width, value);
+    }
+    color = TextColor * vec4(1.0, 1.0, 1.0, alpha);
 }
@@ -1,11 +1,24 @@
 #version 330 core
-layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+layout (location = 0) in vec2 aPos;       // pixels from the top-left corner
+layout (location = 1) in vec2 aTexCoords;  // glyph atlas coordinates
+layout (location = 2) in vec4 aColor;
 out vec2 TexCoords;
+out vec4 TextColor;
 
-uniform mat4 projection;
+// Per-frame camera/lighting/fog state (see FrameData.h)
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 screenProjection; // pixels, origin top-left (text and HUD)
+    vec3 lightPos;   float fogNear;
+    vec3 lightColor; float fogFar;
+    vec3 viewPos;
+    vec3 fogColor;
+};
 
 void main()
 {
-    gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
-    TexCoords = vertex.zw;
+    gl_Position = screenProjection * vec4(aPos, 0.0, 1.0);
+    TexCoords = aTexCoords;
+    TextColor = aColor;
 }
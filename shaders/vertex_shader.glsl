@@ -2,20 +2,47 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
+// Per-instance data for instanced draws (see InstanceData in Model.h)
+layout (location = 3) in mat4 aInstanceModel; // locations 3-6
+layout (location = 7) in vec4 aInstanceColor;
+layout (location = 8) in mat3 aInstanceNormal; // locations 8-10
+
+// Per-frame camera/lighting/fog state (see FrameData.h)
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 screenProjection; // pixels, origin top-left (text and HUD)
+    vec3 lightPos;   float fogNear;
+    vec3 lightColor; float fogFar;
+    vec3 viewPos;
+    vec3 fogColor;
+};
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform mat3 normalMatrix;  // inverse transpose of model, computed on the CPU (see NormalMatrix.h)
+uniform bool useInstancing; // take model and colour from the instance attributes
+
+// Dequantization for packed meshes (see PackedVertex.h); identity for float vertices
+uniform vec3 posScale;
+uniform vec3 posOffset;
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
+out vec3 InstanceColor;
+
+// The depth pre-pass links this same stage into another program; both must produce identical depth
+invariant gl_Position;
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    mat4 world = useInstancing ? aInstanceModel : model;
+    mat3 normalWorld = useInstancing ? aInstanceNormal : normalMatrix;
+    vec3 position = posOffset + aPos * posScale;
+    FragPos = vec3(world * vec4(position, 1.0));
+    Normal = normalWorld * aNormal;
     TexCoords = aTexCoords;
+    InstanceColor = aInstanceColor.rgb;
     
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * world * vec4(position, 1.0);
 }
@@ -107,7 +107,7 @@ bool AudioManager::Initialize()
     return true;
 }
 
-bool AudioManager::LoadAudioFile(const std::string& filePath, ALuint& buffer) 
+bool AudioManager::DecodeAudioFile(const std::string& filePath, AudioClip& clip) 
 {
     // Use libsndfile for audio files (WAV, FLAC, OGG)
     SF_INFO sfInfo;
@@ -125,7 +125,8 @@ bool AudioManager::LoadAudioFile(const std::string& filePath, ALuint& buffer)
               << ", Frames: " << sfInfo.frames << std::endl;
 
     // Read all audio data
-    std::vector<short> audioData(sfInfo.frames * sfInfo.channels);
+    std::vector<short>& audioData = clip.samples;
+    audioData.resize(sfInfo.frames * sfInfo.channels);
     sf_count_t numFrames = sf_readf_short(file, audioData.data(), sfInfo.frames);
     
     if (numFrames != sfInfo.frames) {
@@ -136,14 +137,22 @@ bool AudioManager::LoadAudioFile(const std::string& filePath, ALuint& buffer)
 
     sf_close(file);
 
+    clip.path = filePath;
+    clip.channels = sfInfo.channels;
+    clip.sampleRate = sfInfo.samplerate;
+    return true;
+}
+
+bool AudioManager::UploadClip(const AudioClip& clip, ALuint& buffer) 
+{
     // Determine OpenAL format
     ALenum format;
-    if (sfInfo.channels == 1) {
+    if (clip.channels == 1) {
         format = AL_FORMAT_MONO16;
-    } else if (sfInfo.channels == 2) {
+    } else if (clip.channels == 2) {
         format = AL_FORMAT_STEREO16;
     } else {
-        std::cerr << "Unsupported number of channels: " << sfInfo.channels << std::endl;
+        std::cerr << "Unsupported number of channels: " << clip.channels << std::endl;
         return false;
     }
 
@@ -158,8 +167,8 @@ bool AudioManager::LoadAudioFile(const std::string& filePath, ALuint& buffer)
     }
 
     // Upload audio data to buffer
-    alBufferData(buffer, format, audioData.data(), 
-                 audioData.size() * sizeof(short), sfInfo.samplerate);
+    alBufferData(buffer, format, clip.samples.data(), 
+                 clip.samples.size() * sizeof(short), clip.sampleRate);
 
     ALenum error = alGetError();
     if (error != AL_NO_ERROR) {
@@ -171,7 +180,25 @@ bool AudioManager::LoadAudioFile(const std::string& filePath, ALuint& buffer)
     return true;
 }
 
+bool AudioManager::LoadAudioFile(const std::string& filePath, ALuint& buffer) 
+{
+    AudioClip clip;
+    if (!DecodeAudioFile(filePath, clip)) {
+        return false;
+    }
+    return UploadClip(clip, buffer);
+}
+
 bool AudioManager::PlayMusic(const std::string& filePath) 
+{
+    AudioClip clip;
+    if (!DecodeAudioFile(filePath, clip)) {
+        return false;
+    }
+    return PlayMusic(clip);
+}
+
+bool AudioManager::PlayMusic(const AudioClip& clip) 
 {
     if (sourceId == 0) {
         std::cerr << "Audio system not initialized" << std::endl;
@@ -186,8 +213,8 @@ bool AudioManager::PlayMusic(const std::string& filePath)
         alGenBuffers(1, &bufferId);
     }
 
-    // Load audio file
-    if (!LoadAudioFile(filePath, bufferId)) {
+    // Upload decoded audio
+    if (!UploadClip(clip, bufferId)) {
         return false;
     }
 
@@ -195,11 +222,11 @@ bool AudioManager::PlayMusic(const std::string& filePath)
     alSourcei(sourceId, AL_BUFFER, bufferId);
     alSourcePlay(sourceId);
 
-    currentMusicPath = filePath;
+    currentMusicPath = clip.path;
     musicLoaded = true;
     isPlaying = true;
 
-    std::cout << "Now playing: " << filePath << std::endl;
+    std::cout << "Now playing: " << clip.path << std::endl;
     return true;
 }
 
@@ -8,21 +8,30 @@
 #include "Camera.h"
 #include "Player.h"
 #include "Car.h"
+#include "CarRenderer.h"
+#include "GroundStrip.h"
+#include "RenderQueue.h"
+#include "FrameData.h"
+#include "RenderState.h"
+#include "ModelCache.h"
 #include "AudioManager.h"
 #include "Cubemap.h"
 #include "TextRenderer.h"
+#include "AssetLoader.h"
+#include "FrameStats.h"
+#include "BakedTexture.h"
+#include "GroundLayers.h"
 
 #include <iostream>
 #include <vector>
 #include <ctime>
 #include <cstdlib>
 #include <fstream>
-#include <windows.h>
-#include <gdiplus.h>
 #include <cmath>
 #include <set>
 #include <algorithm>
-#pragma comment(lib, "gdiplus.lib")
+#include <memory>
+#include <cstdio>
 
 // Settings
 const unsigned int SCR_WIDTH = 1280;
@@ -39,8 +48,14 @@ bool keysProcessed[1024] = { false };
 // Audio manager (global for key callbacks)
 AudioManager* g_audioManager = nullptr;
 
-// Models (global for reset access)
-Model* g_tunnelModel = nullptr;
+// True while the AssetLoader is still streaming assets in (MENU shows progress, SPACE is blocked)
+bool g_loadingAssets = true;
+
+// Debug overlay with per-frame render statistics (toggled with F3)
+bool g_showFrameStats = false;
+
+// Depth-only pre-pass before the colour pass (toggled with F4)
+bool g_depthPrepass = false;
 
 // Camera - อยู่ด้านหลังและสูงขึ้น
 Camera camera(glm::vec3(0.0f, 6.0f, 12.0f));
@@ -65,9 +80,9 @@ const float CAR_DESPAWN_DISTANCE = 80.0f; // Remove cars that are far behind
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
 void processInput(GLFWwindow* window, Player* player, AudioManager* audioManager);
-unsigned int createGroundPlane();
-void renderGround(unsigned int VAO, Shader* shader, glm::mat4 view, glm::mat4 projection);
-unsigned int loadTexture(const char* path);
+void loadGroundLayersAsync(AssetLoader& loader, TextureHandle& target);
+void decodeGroundLayers(DecodedImages& images);
+bool decodeTexture(const std::string& path, ImageData& out);
 void loadHighScore();
 void saveHighScore();
 void resetGame(Player* player, std::vector<Car*>& cars, std::vector<GameObject*>& hearts,
@@ -83,12 +98,6 @@ int main()
     // Load high score from file
     loadHighScore();
 
-    // Initialize GDI+
-    using namespace Gdiplus;
-    GdiplusStartupInput gdiplusStartupInput;
-    ULONG_PTR gdiplusToken;
-    GdiplusStartup(&gdiplusToken, &gdiplusStartupInput, NULL);
-
     // GLFW initialization
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -113,6 +122,7 @@ int main()
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
+    TextureCache::DetectCompressionSupport();
 
     // OpenGL configuration
     glEnable(GL_DEPTH_TEST);
@@ -126,10 +136,30 @@ int main()
 
     // Build and compile shaders
     Shader shader("shaders/vertex_shader.glsl", "shaders/fragment_shader.glsl");
+    // Float geometry uses identity dequantization; packed meshes set their own per draw
+    shader.use();
+    shader.setVec3("posScale", glm::vec3(1.0f));
+    shader.setVec3("posOffset", glm::vec3(0.0f));
+    // Same vertex stage without fragment work, for the optional depth pre-pass
+    Shader depthShader("shaders/vertex_shader.glsl", "shaders/depth_fragment.glsl");
+    depthShader.use();
+    depthShader.setVec3("posScale", glm::vec3(1.0f));
+    depthShader.setVec3("posOffset", glm::vec3(0.0f));
+    // Same vertex stage, fragment stage that only textures the ground from its layer array
+    Shader groundShader("shaders/vertex_shader.glsl", "shaders/ground_fragment.glsl");
+    groundShader.use();
+    groundShader.setVec3("posScale", glm::vec3(1.0f));
+    groundShader.setVec3("posOffset", glm::vec3(0.0f));
+    groundShader.setInt("groundLayers", (int)GroundTextureUnit);
+
+    // Asset loading runs on worker threads (file I/O, decoding, Assimp); the game loop
+    // performs the GL uploads a few at a time so the window stays responsive
+    std::unique_ptr<AssetLoader> loader = std::make_unique<AssetLoader>();
+    ModelCache::Instance().SetLoader(loader.get());
 
     // Load cubemap for skybox
     Cubemap* cubemap = new Cubemap();
-    cubemap->LoadCubemap(
+    cubemap->LoadCubemapAsync(*loader,
         "assets/cubemap/px.png",  // posX (right)
         "assets/cubemap/nx.png",  // negX (left)
         "assets/cubemap/py.png",  // posY (top)
@@ -144,6 +174,31 @@ int main()
     // Create Text Renderer for on-screen display
     TextRenderer* textRenderer = new TextRenderer(SCR_WIDTH, SCR_HEIGHT);
 
+    // HUD labels stay laid out on the GPU between frames. Fixed text is set here once; the rest
+    // is Set() every frame from a stack buffer and only re-laid out when the text changes.
+    const glm::vec3 controlsColor(0.9f, 0.9f, 0.9f);
+    const glm::vec3 highScoreColor(1.0f, 0.84f, 0.0f);
+    TextLabel menuTitleLabel("TURTLE ODYSSEY", SCR_WIDTH / 2 - 300.0f, 150.0f, 2.0f, glm::vec3(0.2f, 1.0f, 0.4f), *textRenderer);
+    TextLabel menuPromptLabel(*textRenderer);
+    TextLabel controlsLabels[] = {
+        TextLabel("=== CONTROLS ===", SCR_WIDTH / 2 - 180.0f, 370.0f, 1.0f, glm::vec3(1.0f, 1.0f, 0.5f), *textRenderer),
+        TextLabel("W/A/S/D - Move", 200.0f, 430.0f, 0.8f, controlsColor, *textRenderer),
+        TextLabel("SPACE - Jump", 200.0f, 475.0f, 0.8f, controlsColor, *textRenderer),
+        TextLabel("LEFT SHIFT - Speed Boost (5 sec)", 200.0f, 520.0f, 0.8f, controlsColor, *textRenderer),
+        TextLabel("[ ] - Volume Down/Up", 200.0f, 565.0f, 0.8f, controlsColor, *textRenderer),
+        TextLabel("ESC - Exit Game", 200.0f, 610.0f, 0.8f, controlsColor, *textRenderer),
+    };
+    TextLabel menuHighScoreLabel(*textRenderer);
+    TextLabel distanceLabel(*textRenderer);
+    TextLabel livesLabel(*textRenderer);
+    TextLabel potionsLabel(*textRenderer);
+    TextLabel gameOverTitleLabel("GAME OVER", SCR_WIDTH / 2 - 250.0f, 200.0f, 2.5f, glm::vec3(1.0f, 0.2f, 0.2f), *textRenderer);
+    TextLabel gameOverDistanceLabel(*textRenderer);
+    TextLabel gameOverHighScoreLabel(*textRenderer);
+    TextLabel restartLabel("Press R to Restart", SCR_WIDTH / 2 - 200.0f, 500.0f, 1.2f, glm::vec3(0.7f, 1.0f, 0.7f), *textRenderer);
+    TextLabel exitLabel("Press ESC to Exit", SCR_WIDTH / 2 - 180.0f, 560.0f, 1.0f, controlsColor, *textRenderer);
+    char hudLine[64];
+
     // Create game objects
     Player* player = new Player(glm::vec3(0.0f, 0.5f, 15.0f));
     
@@ -159,6 +214,8 @@ int main()
     // Each texture zone size (must match ground rendering later)
     // Reduced to 3/4 of original so zones change sooner (was 60 -> now 45)
     const float TEXTURE_ZONE_SIZE = 40.0f; // Each zone is 45 units
+    groundShader.use();
+    groundShader.setFloat("textureZoneSize", TEXTURE_ZONE_SIZE);
 
     // Helper: get the Z center of the next street zone (we will treat zone index mod 3 == 2 as street)
     const int STREET_ZONE_MOD = 2; // 0=grass,1=lake,2=street (we want start on grass)
@@ -186,42 +243,42 @@ int main()
     // Hearts (life pickups)
     int playerHearts = 1; // player starts with one heart
 
-    // Load bridge texture
-    unsigned int bridgeTexture = loadTexture("assets/Bridge/textures/istockphoto-1145602814-170667a.jpg");
-
-    // Load heart model (try OBJ then FBX)
-    Model* heartModel = new Model();
-    bool heartModelLoaded = heartModel->loadModel("assets/models/22_ Heart/Heart.obj");
-    if (!heartModelLoaded) {
-        heartModelLoaded = heartModel->loadModel("assets/models/22_ Heart/Heart.fbx");
-        if (!heartModelLoaded) {
-            delete heartModel;
-            heartModel = nullptr;
-            std::cout << "Warning: Could not load heart model; will fallback to simple marker." << std::endl;
-        }
+    // Load heart model (try OBJ then FBX). Models come from the shared cache so every
+    // pickup/car draws the same GPU buffers instead of importing the file again.
+    // While the loader is busy these are placeholders that fill in over the next frames.
+    ModelHandle heartModel = ModelCache::Instance().AcquireFirst({
+        "assets/models/22_ Heart/Heart.obj",
+        "assets/models/22_ Heart/Heart.fbx"
+    });
+    if (!heartModel) {
+        std::cout << "Warning: Could not load heart model; will fallback to simple marker." << std::endl;
     }
 
     // Load potion model
-    Model* potionModel = new Model();
-    bool potionModelLoaded = potionModel->loadModel("assets/models/low_poly_potion.glb");
-    if (!potionModelLoaded) {
-        delete potionModel;
-        potionModel = nullptr;
+    ModelHandle potionModel = ModelCache::Instance().Acquire("assets/models/low_poly_potion.glb");
+    if (!potionModel) {
         std::cout << "Warning: Could not load potion model" << std::endl;
     }
 
     // Load bridge model for car spawn hiding
-    Model* tunnelModel = new Model();
     std::cout << "Attempting to load bridge model from: assets/models/bridge.glb" << std::endl;
-    bool bridgeModelLoaded = tunnelModel->loadModel("assets/models/bridge.glb");
-    if (!bridgeModelLoaded) {
+    ModelHandle tunnelModel = ModelCache::Instance().Acquire("assets/models/bridge.glb");
+    if (!tunnelModel) {
         std::cout << "Warning: Could not load bridge model from assets/bridge.glb - trying alternative formats..." << std::endl;
-        delete tunnelModel;
-        tunnelModel = nullptr;
-    } else {
-        std::cout << "Successfully loaded bridge model from assets/bridge.glb" << std::endl;
     }
 
+    // Keep the car model resident for the whole session so spawn waves after all cars
+    // have despawned don't re-import it
+    ModelHandle carModel = ModelCache::Instance().Acquire(Car::ModelPath);
+    CarRenderer* carRenderer = new CarRenderer();
+    FrameDataBuffer* frameData = new FrameDataBuffer();
+    RenderQueue* renderQueue = new RenderQueue();
+
+    // A model is only known to be missing once its load has finished without success
+    auto modelMissing = [](const ModelHandle& model) {
+        return model == nullptr || (!model->loaded && !model->isPending());
+    };
+
     // Tunnels to hide car spawning (left and right sides)
     std::vector<GameObject*> tunnels;
     // Invisible colliders that match tunnel (bridge) positions to prevent walking through them
@@ -240,13 +297,13 @@ int main()
         h->position = glm::vec3(0.0f, 4.0f, z); // slightly above ground
         h->scale = glm::vec3(1.0f, 1.0f, 1.0f);
         // If no model, shrink marker
-        if (!heartModel) h->scale = glm::vec3(0.5f);
+        if (modelMissing(heartModel)) h->scale = glm::vec3(0.5f);
         hearts.push_back(h);
     };
 
     // Helper lambda for spawning tunnels in street zones
     auto spawnTunnelInZone = [&](int zoneIndex) {
-        if (tunnelModel == nullptr) return;
+        if (modelMissing(tunnelModel)) return;
         
         float z = - (zoneIndex * TEXTURE_ZONE_SIZE + TEXTURE_ZONE_SIZE * 0.5f);
         
@@ -297,7 +354,7 @@ int main()
         p->position = glm::vec3(-8.0f, 2.5f, z);
         p->scale = glm::vec3(0.5f, 0.5f, 0.5f);
         p->rotation = glm::vec3(-90.0f, 0.0f, 0.0f); // Upright - no rotation
-        if (!potionModel) p->scale = glm::vec3(0.4f);
+        if (modelMissing(potionModel)) p->scale = glm::vec3(0.4f);
         potions.push_back(p);
     };
 
@@ -340,13 +397,19 @@ int main()
         }
     }
     
-    // Start playing background music
+    // Start playing background music (decoded on a worker, played once uploaded)
     std::string musicPath = "assets/sound/Zambolino - Beautiful Day (freetouse.com).mp3";
-    if (!audioManager.PlayMusic(musicPath)) {
-        std::cerr << "Warning: Could not load music from " << musicPath << std::endl;
-        std::cerr << "Note: MP3 files are not supported. Please convert to WAV format." << std::endl;
-        std::cerr << "You can convert using: ffmpeg -i input.mp3 -acodec pcm_s16le -ar 44100 output.wav" << std::endl;
-    }
+    loader->Enqueue([&audioManager, musicPath]() -> AssetLoader::UploadStep {
+        auto clip = std::make_shared<AudioClip>();
+        bool decoded = AudioManager::DecodeAudioFile(musicPath, *clip);
+        return [&audioManager, musicPath, clip, decoded]() {
+            if (!decoded || !audioManager.PlayMusic(*clip)) {
+                std::cerr << "Warning: Could not load music from " << musicPath << std::endl;
+                std::cerr << "Note: MP3 files are not supported. Please convert to WAV format." << std::endl;
+                std::cerr << "You can convert using: ffmpeg -i input.mp3 -acodec pcm_s16le -ar 44100 output.wav" << std::endl;
+            }
+        };
+    });
     
     // Create multiple cars - กระจายตามเลน (Z axis) พร้อมการเว้นช่องห่าง
     for (int i = 0; i < 8; i++) {
@@ -377,18 +440,17 @@ int main()
         cars.push_back(car);
     }
 
-    // Create ground
-    unsigned int groundVAO = createGroundPlane();
+    // Ground: one strip covering the zones around the player, drawn in a single call.
+    // Raise these to see further; the draw count stays the same.
+    const int GROUND_ZONES_BEHIND = 4;
+    const int GROUND_ZONES_AHEAD = 4;
+    GroundStrip* groundStrip = new GroundStrip(TEXTURE_ZONE_SIZE, GROUND_ZONES_BEHIND, GROUND_ZONES_AHEAD);
     
-    // Load three textures for ground cycling
-    unsigned int grassTexture = loadTexture("assets/textures/grass.jpg");
-    unsigned int lakeTexture = loadTexture("assets/textures/lake.png");
-    unsigned int streetTexture = loadTexture("assets/textures/street.jpg");
-
-    // Store textures in array for easy access
+    // Ground textures as one array (streamed in; the ground is untextured until it arrives).
     // We want the world to start with grass, then lake, then street repeating.
-    // So index 0 = grass, 1 = lake, 2 = street
-    unsigned int groundTextures[3] = { grassTexture, lakeTexture, streetTexture };
+    // So layer 0 = grass, 1 = lake, 2 = street (3 = bridge over the lake)
+    TextureHandle groundLayers;
+    loadGroundLayersAsync(*loader, groundLayers);
     // current texture zone index (0=grass,1=lake,2=street)
     int currentTextureZone = 0;
 
@@ -401,6 +463,8 @@ int main()
     float fogFar = 180.0f;      // Distance where fog is complete
     glm::vec3 fogColor(0.0f, 0.0f, 0.0f); // Black fog - makes distant objects fade to black
 
+    std::cout << "Streaming " << loader->Total() << " assets on background threads..." << std::endl;
+
     std::cout << "=== Turtle Odyssey ===" << std::endl;
     std::cout << "Controls:" << std::endl;
     std::cout << "W/A/S/D - Move" << std::endl;
@@ -408,6 +472,8 @@ int main()
     std::cout << "LEFT SHIFT - Speed Boost (5 sec)" << std::endl;
     std::cout << "[ ] - Decrease/Increase Volume" << std::endl;
     std::cout << "R - Restart Game (when game over)" << std::endl;
+    std::cout << "F3 - Toggle render stats overlay" << std::endl;
+    std::cout << "F4 - Toggle depth pre-pass" << std::endl;
     std::cout << "ESC - Exit" << std::endl;
     std::cout << "Goal: Survive as long as possible!" << std::endl;
     std::cout << "======================" << std::endl;
@@ -420,6 +486,18 @@ int main()
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
+        // Finish a few pending asset uploads (GL work stays on this thread)
+        if (g_loadingAssets) {
+            loader->PumpUploads(0.004);
+            if (loader->IsDone()) {
+                g_loadingAssets = false;
+                ModelCache::Instance().SetLoader(nullptr);
+                std::cout << "All assets loaded after " << glfwGetTime() << " s" << std::endl;
+                ModelCache::Instance().PrintStats();
+                TextureCache::Instance().PrintStats();
+            }
+        }
+
         // Save last safe player position BEFORE applying input movement
         glm::vec3 lastSafePos = player->position;
 
@@ -705,144 +783,92 @@ if (player->position.z < lastCarSpawnZ - CAR_SPAWN_INTERVAL) {
         }
 
         // Render
+        FrameStats::Instance().BeginFrame();
+        // GL objects deleted and recreated since the last frame may reuse names the tracker
+        // still thinks are bound
+        RenderState::Instance().Invalidate();
         glClearColor(0.53f, 0.81f, 0.92f, 1.0f); // Sky blue
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // Render skybox first (before other objects)
-        glDepthFunc(GL_LEQUAL);  // Change depth function so depth test passes when values are equal to depth buffer's content
-        skyboxShader.use();
         glm::mat4 projection = glm::perspective(glm::radians(60.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 200.0f);
         glm::mat4 view = camera.GetViewMatrix();
-        skyboxShader.setMat4("projection", projection);
-        skyboxShader.setMat4("view", view);
-        cubemap->Draw();
-        glDepthFunc(GL_LESS); // Set depth function back to default
+        // Screen-space LOD selection uses the same camera/FOV as the projection above
+        Model::lodView.cameraPos = camera.Position;
+        Model::lodView.pixelsPerUnit = (float)SCR_HEIGHT / (2.0f * std::tan(glm::radians(60.0f) * 0.5f));
+
+        // Camera, lighting and fog for every shader, in one upload
+        FrameData frame = {};
+        frame.view = view;
+        frame.projection = projection;
+        frame.screenProjection = glm::ortho(0.0f, (float)SCR_WIDTH, (float)SCR_HEIGHT, 0.0f, -1.0f, 1.0f);
+        frame.lightPos = lightPos;
+        frame.lightColor = lightColor;
+        frame.viewPos = camera.Position;
+        frame.fogNear = fogNear;
+        frame.fogFar = fogFar;
+        frame.fogColor = fogColor;
+        frameData->Update(frame);
 
         // Activate shader for regular objects
         shader.use();
 
-        // View/projection transformations
-        shader.setMat4("projection", projection);
-        shader.setMat4("view", view);
-
     // Ensure default object texture uniform points to texture unit 0
     shader.setInt("ourTexture", 0);
 
-        // Lighting uniforms
-        shader.setVec3("lightPos", lightPos);
-        shader.setVec3("lightColor", lightColor);
-        shader.setVec3("viewPos", camera.Position);
+        // Collect this frame's draws; the queue sorts them by state before issuing them
+        renderQueue->Begin(projection * view, camera.Position, 200.0f);
+        renderQueue->SetDepthPrepass(g_depthPrepass ? &depthShader : nullptr);
+        renderQueue->SetCountFragments(g_showFrameStats);
 
-        // Fog uniforms
-        shader.setFloat("fogNear", fogNear);
-        shader.setFloat("fogFar", fogFar);
-        shader.setVec3("fogColor", fogColor);
+        // The ground strip follows the player's zone; ground_fragment.glsl picks each zone's texture from FragPos.z
+        renderQueue->SubmitGround(groundShader, groundStrip->VertexArray(), groundStrip->VertexCount(),
+                                  groundStrip->Placement(player->position.z), groundLayers ? groundLayers->id : 0u);
 
-        // Render multiple ground sections with different textures
-        // This creates a continuous visible transition between terrain types
-    const float SECTION_SIZE = TEXTURE_ZONE_SIZE; // Size of each ground section (match zone size)
-        
-        // Bind all three ground textures to texture units 0..2 and inform shader
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, groundTextures[0]);
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, groundTextures[1]);
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, groundTextures[2]);
-        glActiveTexture(GL_TEXTURE3);
-        glBindTexture(GL_TEXTURE_2D, bridgeTexture);
-    shader.setInt("groundTex[0]", 0);
-    shader.setInt("groundTex[1]", 1);
-    shader.setInt("groundTex[2]", 2);
-    shader.setInt("bridgeTexture", 3);
-        shader.setFloat("textureZoneSize", TEXTURE_ZONE_SIZE);
-        shader.setBool("useGroundTextures", true);
-        shader.setBool("showBridgeInLake", true);  // Show wood bridge texture in lake zones
-
-        // Render multiple sections centered around the player's current zone so the ground follows the player
-        // Calculate the base zone index the player is currently in (zones use negative Z forward)
-        int baseZone = static_cast<int>(-player->position.z / SECTION_SIZE);
-        // Render 9 sections: 4 behind, current, 4 ahead relative to player's zone
-        for (int i = -4; i <= 4; ++i) {
-            int sectionZone = baseZone + i;
-            // compute the world Z coordinate at the center of that section
-            float sectionCenterZ = - (sectionZone * SECTION_SIZE + SECTION_SIZE * 0.5f);
-
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(0.0f, 0.0f, sectionCenterZ));
-            shader.setMat4("model", model);
-            shader.setVec3("objectColor", glm::vec3(1.0f, 1.0f, 1.0f)); // White - let texture show
-
-            // Render this section (fragment shader will pick and blend textures based on FragPos.z)
-            glBindVertexArray(groundVAO);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-            glBindVertexArray(0);
-        }
-
-        // Turn off ground-specific texturing for other objects
-        shader.setBool("useGroundTextures", false);
-
-        // Bind default texture unit for other objects (will use white if no texture loaded)
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, 0); // White texture as default
-
-        // Render player
-        shader.setMat4("model", player->GetModelMatrix());
-        if (player->hasSpeedBoost) {
-            shader.setVec3("objectColor", glm::vec3(0.5f, 1.0f, 0.5f)); // Bright green when boosted
+        // Player: bright green when boosted, otherwise white so the texture shows
+        glm::vec3 playerColor = player->hasSpeedBoost ? glm::vec3(0.5f, 1.0f, 0.5f) : glm::vec3(1.0f, 1.0f, 1.0f);
+        if (player->UsesModel()) {
+            renderQueue->SubmitModel(shader, *player->model, player->GetModelMatrix(), player->lodLevel, playerColor, false);
         } else {
-            shader.setVec3("objectColor", glm::vec3(1.0f, 1.0f, 1.0f)); // White - ให้ texture แสดง
+            renderQueue->SubmitObject(shader, *player, playerColor);
         }
-        player->Draw();
 
-        // Render cars
+        // Cars: model cars are batched into instanced draws, fallback boxes queued one by one
+        carRenderer->Begin();
         for (auto car : cars) {
-            shader.setMat4("model", car->GetModelMatrix());
-            shader.setVec3("objectColor", car->color);
-            car->Draw();
+            if (!carRenderer->Submit(*car, *renderQueue)) renderQueue->SubmitObject(shader, *car, car->color);
         }
+        carRenderer->Flush(*renderQueue, shader);
 
-        // Render hearts (life pickups)
+        // Hearts (life pickups): the model in solid red (overriding its textures), or a red marker
         for (auto h : hearts) {
-            shader.setMat4("model", h->GetModelMatrix());
-            if (heartModel) {
-                // Force a solid red color for the heart model (override any model textures)
-                shader.setVec3("objectColor", glm::vec3(1.0f, 0.0f, 0.0f));
-                shader.setBool("overrideColor", true);
-                heartModel->Draw();
-                shader.setBool("overrideColor", false);
-            } else {
-                // Fallback: draw a simple red marker using GameObject's mesh
-                shader.setVec3("objectColor", glm::vec3(1.0f, 0.0f, 0.0f));
-                h->Draw();
+            if (heartModel && heartModel->loaded) {
+                renderQueue->SubmitModel(shader, *heartModel, h->GetModelMatrix(), h->lodLevel, glm::vec3(1.0f, 0.0f, 0.0f), true);
+            } else if (modelMissing(heartModel)) {
+                renderQueue->SubmitObject(shader, *h, glm::vec3(1.0f, 0.0f, 0.0f));
             }
         }
 
-        // Render potions (power-up pickups)
+        // Potions (power-up pickups) in purple/magenta
         for (auto p : potions) {
-            shader.setMat4("model", p->GetModelMatrix());
-            if (potionModel) {
-                // Force a purple/magenta color for the potion
-                shader.setVec3("objectColor", glm::vec3(1.0f, 0.0f, 1.0f));
-                shader.setBool("overrideColor", true);
-                potionModel->Draw();
-                shader.setBool("overrideColor", false);
-            } else {
-                // Fallback: draw a simple purple marker using GameObject's mesh
-                shader.setVec3("objectColor", glm::vec3(1.0f, 0.0f, 1.0f));
-                p->Draw();
+            if (potionModel && potionModel->loaded) {
+                renderQueue->SubmitModel(shader, *potionModel, p->GetModelMatrix(), p->lodLevel, glm::vec3(1.0f, 0.0f, 1.0f), true);
+            } else if (modelMissing(potionModel)) {
+                renderQueue->SubmitObject(shader, *p, glm::vec3(1.0f, 0.0f, 1.0f));
             }
         }
 
-        // Render bridges (hide car spawning on street zones)
-        for (auto t : tunnels) {
-            shader.setMat4("model", t->GetModelMatrix());
-            shader.setVec3("objectColor", glm::vec3(0.8f, 0.7f, 0.6f)); // Light brown/bridge color
-            if (tunnelModel) {
-                tunnelModel->Draw();
+        // Bridges (hide car spawning on street zones)
+        if (tunnelModel && tunnelModel->loaded) {
+            for (auto t : tunnels) {
+                renderQueue->SubmitModel(shader, *tunnelModel, t->GetModelMatrix(), t->lodLevel, glm::vec3(0.8f, 0.7f, 0.6f), false);
             }
         }
 
+        // Skybox last: it sits on the far plane, so only pixels nothing else covered shade it
+        renderQueue->SubmitSky(skyboxShader, cubemap->VAO, Cubemap::VertexCount, cubemap->textureID);
+
+        renderQueue->Execute();
+
         // Bridges are now rendered as ground texture in lake zones instead of separate objects
 
         // Draw HUD text on screen based on game state
@@ -851,45 +877,77 @@ if (player->position.z < lastCarSpawnZ - CAR_SPAWN_INTERVAL) {
 
         if (gameState == MENU) {
             // Start menu screen
-            textRenderer->RenderText("TURTLE ODYSSEY", SCR_WIDTH / 2 - 300.0f, 150.0f, 2.0f, glm::vec3(0.2f, 1.0f, 0.4f), SCR_WIDTH, SCR_HEIGHT);
-            textRenderer->RenderText("Press SPACE to Start", SCR_WIDTH / 2 - 200.0f, 280.0f, 1.2f, glm::vec3(1.0f, 1.0f, 1.0f), SCR_WIDTH, SCR_HEIGHT);
-
-            float yOffset = 370.0f;
-            textRenderer->RenderText("=== CONTROLS ===", SCR_WIDTH / 2 - 180.0f, yOffset, 1.0f, glm::vec3(1.0f, 1.0f, 0.5f), SCR_WIDTH, SCR_HEIGHT);
-            yOffset += 60.0f;
-            textRenderer->RenderText("W/A/S/D - Move", 200.0f, yOffset, 0.8f, glm::vec3(0.9f, 0.9f, 0.9f), SCR_WIDTH, SCR_HEIGHT);
-            yOffset += 45.0f;
-            textRenderer->RenderText("SPACE - Jump", 200.0f, yOffset, 0.8f, glm::vec3(0.9f, 0.9f, 0.9f), SCR_WIDTH, SCR_HEIGHT);
-            yOffset += 45.0f;
-            textRenderer->RenderText("LEFT SHIFT - Speed Boost (5 sec)", 200.0f, yOffset, 0.8f, glm::vec3(0.9f, 0.9f, 0.9f), SCR_WIDTH, SCR_HEIGHT);
-            yOffset += 45.0f;
-            textRenderer->RenderText("[ ] - Volume Down/Up", 200.0f, yOffset, 0.8f, glm::vec3(0.9f, 0.9f, 0.9f), SCR_WIDTH, SCR_HEIGHT);
-            yOffset += 45.0f;
-            textRenderer->RenderText("ESC - Exit Game", 200.0f, yOffset, 0.8f, glm::vec3(0.9f, 0.9f, 0.9f), SCR_WIDTH, SCR_HEIGHT);
+            menuTitleLabel.Draw();
+            if (g_loadingAssets) {
+                int percent = static_cast<int>(loader->Progress() * 100.0f);
+                std::snprintf(hudLine, sizeof(hudLine), "Loading... %d%%", percent);
+                menuPromptLabel.Set(hudLine, SCR_WIDTH / 2 - 150.0f, 280.0f, 1.2f, glm::vec3(1.0f, 1.0f, 0.5f));
+            } else {
+                menuPromptLabel.Set("Press SPACE to Start", SCR_WIDTH / 2 - 200.0f, 280.0f, 1.2f, glm::vec3(1.0f, 1.0f, 1.0f));
+            }
+            menuPromptLabel.Draw();
+
+            for (TextLabel& label : controlsLabels) label.Draw();
 
             if (highScore > 0) {
-                textRenderer->RenderText("High Score: " + std::to_string(highScore * 2) + "m", SCR_WIDTH / 2 - 180.0f, SCR_HEIGHT - 100.0f, 1.2f, glm::vec3(1.0f, 0.84f, 0.0f), SCR_WIDTH, SCR_HEIGHT);
+                std::snprintf(hudLine, sizeof(hudLine), "High Score: %dm", highScore * 2);
+                menuHighScoreLabel.Set(hudLine, SCR_WIDTH / 2 - 180.0f, SCR_HEIGHT - 100.0f, 1.2f, highScoreColor);
+                menuHighScoreLabel.Draw();
             }
         } else if (gameState == PLAYING) {
             // In-game HUD
-            textRenderer->RenderText("Distance: " + std::to_string(score * 2) + "m", 20.0f, 30.0f, 1.0f, glm::vec3(1.0f, 1.0f, 1.0f), SCR_WIDTH, SCR_HEIGHT);
-            textRenderer->RenderText("Lives: " + std::to_string(playerHearts), SCR_WIDTH - 250.0f, 30.0f, 1.0f, glm::vec3(1.0f, 0.3f, 0.3f), SCR_WIDTH, SCR_HEIGHT);
-            textRenderer->RenderText("Potions: " + std::to_string(player->potionCount), SCR_WIDTH - 250.0f, 90.0f, 1.0f, glm::vec3(1.0f, 0.0f, 1.0f), SCR_WIDTH, SCR_HEIGHT);
+            std::snprintf(hudLine, sizeof(hudLine), "Distance: %dm", score * 2);
+            distanceLabel.Set(hudLine, 20.0f, 30.0f, 1.0f, glm::vec3(1.0f, 1.0f, 1.0f));
+            distanceLabel.Draw();
+            std::snprintf(hudLine, sizeof(hudLine), "Lives: %d", playerHearts);
+            livesLabel.Set(hudLine, SCR_WIDTH - 250.0f, 30.0f, 1.0f, glm::vec3(1.0f, 0.3f, 0.3f));
+            livesLabel.Draw();
+            std::snprintf(hudLine, sizeof(hudLine), "Potions: %d", player->potionCount);
+            potionsLabel.Set(hudLine, SCR_WIDTH - 250.0f, 90.0f, 1.0f, glm::vec3(1.0f, 0.0f, 1.0f));
+            potionsLabel.Draw();
         } else if (gameState == GAME_OVER) {
             // Game over screen
-            textRenderer->RenderText("GAME OVER", SCR_WIDTH / 2 - 250.0f, 200.0f, 2.5f, glm::vec3(1.0f, 0.2f, 0.2f), SCR_WIDTH, SCR_HEIGHT);
-            textRenderer->RenderText("Distance: " + std::to_string(score * 2) + "m", SCR_WIDTH / 2 - 200.0f, 330.0f, 1.5f, glm::vec3(1.0f, 1.0f, 1.0f), SCR_WIDTH, SCR_HEIGHT);
+            gameOverTitleLabel.Draw();
+            std::snprintf(hudLine, sizeof(hudLine), "Distance: %dm", score * 2);
+            gameOverDistanceLabel.Set(hudLine, SCR_WIDTH / 2 - 200.0f, 330.0f, 1.5f, glm::vec3(1.0f, 1.0f, 1.0f));
+            gameOverDistanceLabel.Draw();
 
             if (score >= highScore) {
-                textRenderer->RenderText("NEW HIGH SCORE!", SCR_WIDTH / 2 - 220.0f, 400.0f, 1.3f, glm::vec3(1.0f, 0.84f, 0.0f), SCR_WIDTH, SCR_HEIGHT);
+                gameOverHighScoreLabel.Set("NEW HIGH SCORE!", SCR_WIDTH / 2 - 220.0f, 400.0f, 1.3f, highScoreColor);
             } else {
-                textRenderer->RenderText("High Score: " + std::to_string(highScore * 2) + "m", SCR_WIDTH / 2 - 220.0f, 400.0f, 1.3f, glm::vec3(1.0f, 0.84f, 0.0f), SCR_WIDTH, SCR_HEIGHT);
+                std::snprintf(hudLine, sizeof(hudLine), "High Score: %dm", highScore * 2);
+                gameOverHighScoreLabel.Set(hudLine, SCR_WIDTH / 2 - 220.0f, 400.0f, 1.3f, highScoreColor);
             }
+            gameOverHighScoreLabel.Draw();
 
-            textRenderer->RenderText("Press R to Restart", SCR_WIDTH / 2 - 200.0f, 500.0f, 1.2f, glm::vec3(0.7f, 1.0f, 0.7f), SCR_WIDTH, SCR_HEIGHT);
-            textRenderer->RenderText("Press ESC to Exit", SCR_WIDTH / 2 - 180.0f, 560.0f, 1.0f, glm::vec3(0.9f, 0.9f, 0.9f), SCR_WIDTH, SCR_HEIGHT);
+            restartLabel.Draw();
+            exitLabel.Draw();
         }
 
+        if (g_showFrameStats) {
+            // Debug overlay: triangles per level of detail, culling, binds, uniform uploads and text draws
+            const FrameStats& stats = FrameStats::Instance();
+            float statsY = SCR_HEIGHT - 40.0f - 30.0f * (MaxLodLevels + 5);
+            textRenderer->RenderText("Triangles: " + std::to_string(stats.TotalTriangles()), 20.0f, statsY, 0.6f, glm::vec3(0.6f, 1.0f, 0.6f));
+            for (int level = 0; level < MaxLodLevels; ++level) {
+                statsY += 30.0f;
+                textRenderer->RenderText(stats.LodLine(level), 20.0f, statsY, 0.6f, glm::vec3(0.6f, 1.0f, 0.6f));
+            }
+            statsY += 30.0f;
+            textRenderer->RenderText(stats.CullingLine(), 20.0f, statsY, 0.6f, glm::vec3(0.6f, 1.0f, 0.6f));
+            statsY += 30.0f;
+            textRenderer->RenderText(stats.FragmentLine(), 20.0f, statsY, 0.6f, glm::vec3(0.6f, 1.0f, 0.6f));
+            statsY += 30.0f;
+            textRenderer->RenderText(stats.StateLine(), 20.0f, statsY, 0.6f, glm::vec3(0.6f, 1.0f, 0.6f));
+            statsY += 30.0f;
+            textRenderer->RenderText(stats.UniformLine(), 20.0f, statsY, 0.6f, glm::vec3(0.6f, 1.0f, 0.6f));
+            statsY += 30.0f;
+            textRenderer->RenderText(stats.TextLine(), 20.0f, statsY, 0.6f, glm::vec3(0.6f, 1.0f, 0.6f));
+        }
+
+        // All of this frame's text in one draw
+        textRenderer->Flush();
+
         glDisable(GL_BLEND);
 
         // Swap buffers and poll events
@@ -898,8 +956,14 @@ if (player->position.z < lastCarSpawnZ - CAR_SPAWN_INTERVAL) {
     }
 
     // Cleanup
+    // Stop the loader first: queued uploads hold models/textures that must die while GL is alive
+    ModelCache::Instance().SetLoader(nullptr);
+    loader.reset();
     delete player;
     if (textRenderer) delete textRenderer;
+    delete carRenderer;
+    delete frameData;
+    delete renderQueue;
     for (size_t i = 0; i < cars.size(); ++i) {
         delete cars[i];
     }
@@ -920,15 +984,15 @@ if (player->position.z < lastCarSpawnZ - CAR_SPAWN_INTERVAL) {
         delete bridgeColliders[i];
     }
     bridgeColliders.clear();
-    if (heartModel) delete heartModel;
-    if (potionModel) delete potionModel;
-    if (tunnelModel) delete tunnelModel;
+    heartModel.reset();
+    potionModel.reset();
+    tunnelModel.reset();
+    carModel.reset();
+    ModelCache::Instance().PrintStats();
     if (cubemap) delete cubemap;
-    glDeleteVertexArrays(1, &groundVAO);
-    glDeleteTextures(3, groundTextures);
-
-    // Shutdown GDI+
-    Gdiplus::GdiplusShutdown(gdiplusToken);
+    delete groundStrip;
+    groundLayers.reset();
+    TextureCache::Instance().PrintStats();
 
     glfwTerminate();
     return 0;
@@ -936,8 +1000,8 @@ if (player->position.z < lastCarSpawnZ - CAR_SPAWN_INTERVAL) {
 
 void processInput(GLFWwindow* window, Player* player, AudioManager* audioManager)
 {
-    // Handle SPACE key to start game from menu
-    if (gameState == MENU && keys[GLFW_KEY_SPACE] && !keysProcessed[GLFW_KEY_SPACE]) {
+    // Handle SPACE key to start game from menu (once every asset has streamed in)
+    if (gameState == MENU && !g_loadingAssets && keys[GLFW_KEY_SPACE] && !keysProcessed[GLFW_KEY_SPACE]) {
         gameState = PLAYING;
         keysProcessed[GLFW_KEY_SPACE] = true;
         std::cout << "Game started!" << std::endl;
@@ -992,6 +1056,17 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     // R key to restart game (handled in main loop through global variables)
     // The actual reset logic will be in the main loop
 
+    // F3 toggles the render statistics overlay
+    if (key == GLFW_KEY_F3 && action == GLFW_PRESS) {
+        g_showFrameStats = !g_showFrameStats;
+    }
+
+    // F4 toggles the depth pre-pass (compare the fragment counts in the F3 overlay)
+    if (key == GLFW_KEY_F4 && action == GLFW_PRESS) {
+        g_depthPrepass = !g_depthPrepass;
+        std::cout << "Depth pre-pass " << (g_depthPrepass ? "on" : "off") << std::endl;
+    }
+
     // Volume control with [ and ]
     if (key == GLFW_KEY_LEFT_BRACKET && action == GLFW_PRESS) {
         if (g_audioManager) {
@@ -1028,166 +1103,65 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
     glViewport(0, 0, width, height);
 }
 
-unsigned int createGroundPlane()
+// Decode every ground layer into 'images', ready for AcquireArray. CPU only.
+void decodeGroundLayers(DecodedImages& images)
 {
-    // Create a ground section (20 units long for terrain transitions)
-    // Each section will be rendered multiple times at different Z positions
-    float width = 500.0f;   // Wide enough for all lanes
-    float depth = 40.0f;    // Length of one section (matches SECTION_SIZE / TEXTURE_ZONE_SIZE) - reduced to 3/4
-    
-    // Texture coordinate scale - higher values = more tiling = smaller/more detailed textures
-    // Scale based on the actual dimensions to avoid stretching
-    float texScaleZ = 8.0f;  // Repeat texture 8 times along Z (depth)
-    float texScaleX = texScaleZ * (width / depth);  // Scale X proportionally to avoid stretching
-    
-    float groundVertices[] = {
-        // positions                texCoords        
-        -width, 0.0f, -depth,      0.0f, 0.0f,
-         width, 0.0f, -depth,      texScaleX, 0.0f,
-         width, 0.0f,  depth,      texScaleX, texScaleZ,
-
-         width, 0.0f,  depth,      texScaleX, texScaleZ,
-        -width, 0.0f,  depth,      0.0f, texScaleZ,
-        -width, 0.0f, -depth,      0.0f, 0.0f,
-    };
-
-    unsigned int VBO, VAO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(groundVertices), groundVertices, GL_STATIC_DRAW);
-
-    // Position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    // Texture coordinate attribute
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    const std::vector<std::string>& layers = GroundLayers::Layers();
+    std::vector<ImageData> decoded(layers.size());
+    // Every layer but the last, BridgeOverWater, decodes like any texture; that one only
+    // exists baked (stamped with the bridge image) and is blended here otherwise
+    for (size_t i = 0; i + 1 < layers.size(); ++i) decodeTexture(layers[i], decoded[i]);
+    const ImageData& water = decoded[1];
+
+    ImageData& bridge = decoded.back();
+    if (BakedTexture::Load(BakedTexture::PathFor(GroundLayers::BridgeOverWater), GroundLayers::Bridge, bridge)) {
+        std::cout << "Successfully loaded texture: " << GroundLayers::BridgeOverWater << " (baked)" << std::endl;
+    } else {
+        std::vector<ImageData> pair(2);
+        decodeTexture(GroundLayers::Bridge, pair[0]);
+        pair[1] = water;
+        TextureCache::NormalizeLayers(pair);
+        GroundLayers::BlendBridgeOverWater(pair[0], pair[1]);
+        bridge = std::move(pair[0]);
+    }
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    // Layers baked as a set upload as-is; anything else is converted here, off the main thread
+    if (!TextureCache::LayersMatch(decoded)) TextureCache::NormalizeLayers(decoded);
 
-    return VAO;
+    for (size_t i = 0; i < layers.size(); ++i) images[layers[i]] = std::move(decoded[i]);
 }
 
-void renderGround(unsigned int VAO, Shader* shader, glm::mat4 view, glm::mat4 projection)
+void loadGroundLayersAsync(AssetLoader& loader, TextureHandle& target)
 {
-    glm::mat4 model = glm::mat4(1.0f);
-    shader->setMat4("model", model);
-    shader->setVec3("objectColor", glm::vec3(1.0f, 1.0f, 1.0f)); // White - let texture show
-
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
+    loader.Enqueue([&target]() -> AssetLoader::UploadStep {
+        // Nothing to decode if the array is cached already; the upload just takes the handle
+        auto images = std::make_shared<DecodedImages>();
+        if (!TextureCache::Instance().Contains(TextureCache::ArrayKey("ground", SamplerDesc::Repeat()))) {
+            decodeGroundLayers(*images);
+        }
+        return [&target, images]() {
+            // The cached array was released after the check: decode the layers here after all
+            ImageDecoder decodeMissing = [images](const std::string& path, ImageData& out) {
+                decodeGroundLayers(*images);
+                return TextureCache::FromDecoded(*images)(path, out);
+            };
+            target = TextureCache::Instance().AcquireArray("ground", GroundLayers::Layers(), SamplerDesc::Repeat(),
+                                                           TextureCache::FromDecoded(*images, decodeMissing));
+        };
+    });
 }
 
-unsigned int loadTexture(const char* path)
+bool decodeTexture(const std::string& path, ImageData& out)
 {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-
-    // Use GDI+ to load the image
-    using namespace Gdiplus;
-    
-    // Convert char* to wchar_t*
-    int len = strlen(path);
-    wchar_t* widePath = new wchar_t[len + 1];
-    mbstowcs(widePath, path, len + 1);
-    
-    Image* image = new Image(widePath);
-    delete[] widePath;
-    
-    if (image->GetLastStatus() != Ok || image->GetWidth() == 0 || image->GetHeight() == 0) {
-        std::cout << "Warning: Failed to load image: " << path << std::endl;
-        delete image;
-        
-        // Create fallback texture - solid color based on filename
-        std::string filename(path);
-        unsigned char* data = new unsigned char[128 * 128 * 3];
-        
-        if (filename.find("street") != std::string::npos) {
-            for (int i = 0; i < 128 * 128 * 3; i += 3) {
-                data[i] = 60; data[i + 1] = 60; data[i + 2] = 60; // Gray
-            }
-        } else if (filename.find("grass") != std::string::npos) {
-            for (int i = 0; i < 128 * 128 * 3; i += 3) {
-                data[i] = 34; data[i + 1] = 139; data[i + 2] = 34; // Green
-            }
-        } else if (filename.find("lake") != std::string::npos) {
-            for (int i = 0; i < 128 * 128 * 3; i += 3) {
-                data[i] = 30; data[i + 1] = 144; data[i + 2] = 255; // Blue
-            }
-        }
-        
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    // Ensure proper alignment for tightly-packed data
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 128, 128, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        delete[] data;
-        return textureID;
-    }
-    
-    UINT width = image->GetWidth();
-    UINT height = image->GetHeight();
-    
-    // Create an RGBA bitmap to preserve alpha if present
-    Bitmap* bitmap = new Bitmap(width, height, PixelFormat32bppARGB);
-    Graphics* graphics = Graphics::FromImage(bitmap);
-    graphics->DrawImage(image, 0, 0);
-    delete graphics;
-
-    // Lock bitmap bits for reading (32bpp ARGB)
-    BitmapData bitmapData;
-    Rect rect(0, 0, width, height);
-    bitmap->LockBits(&rect, ImageLockModeRead, PixelFormat32bppARGB, &bitmapData);
-
-    unsigned char* pixels = static_cast<unsigned char*>(bitmapData.Scan0);
-    unsigned char* textureData = new unsigned char[width * height * 4];
-
-    // Copy and convert BGRA -> RGBA (GDI+ uses BGRA ordering for 32bpp)
-    for (UINT y = 0; y < height; ++y) {
-        for (UINT x = 0; x < width; ++x) {
-            int src_idx = (y * bitmapData.Stride) + (x * 4);
-            int dst_idx = (y * width + x) * 4;
-            // BGRA -> RGBA
-            textureData[dst_idx + 0] = pixels[src_idx + 2]; // R
-            textureData[dst_idx + 1] = pixels[src_idx + 1]; // G
-            textureData[dst_idx + 2] = pixels[src_idx + 0]; // B
-            textureData[dst_idx + 3] = pixels[src_idx + 3]; // A
-        }
+    if (BakedTexture::Decode(path, out)) {
+        std::cout << "Successfully loaded texture: " << path << " (" << out.width << "x" << out.height
+                  << (out.mips.empty() ? "" : ", baked mips") << ")" << std::endl;
+        return true;
     }
 
-    bitmap->UnlockBits(&bitmapData);
-
-    // Upload to OpenGL (use RGBA)
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, textureData);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Cleanup
-    delete[] textureData;
-    delete bitmap;
-    delete image;
-
-    std::cout << "Successfully loaded texture: " << path << " (" << width << "x" << height << ")" << std::endl;
-
-    return textureID;
+    // Missing ground textures get a solid colour based on the filename
+    GroundLayers::FillMissing(path, out);
+    return true;
 }
 
 void loadHighScore()
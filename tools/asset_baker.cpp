@@ -0,0 +1,311 @@
+// asset_baker - converts source models (OBJ/FBX/GLB) into the binary .tmesh format
+// that Model::loadBaked memory-maps at startup, and images into .ttex textures with
+// a precomputed, block-compressed mip chain.
+//
+// Usage: asset_baker [--force] [--format auto|bc1|bc3|bc7|raw] [--vertices packed|float]
+//                    [--ground] [model or image paths...]
+// --format auto (default) picks BC1 for opaque images and BC7 for images with alpha.
+// --vertices packed (default) stores quantized PackedVertex data; float keeps full precision.
+// --ground bakes the ground layers along with the given paths.
+// With no paths, bakes every model the game loads plus the textures they reference,
+// the skybox and the ground layers (see BakeGroundLayers). Run it from the directory that contains assets/ (the repo
+// root or the build output folder). Baked files are written next to their source as
+// <source>.tmesh / <source>.ttex.
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "ModelImporter.h"
+#include "BakedModel.h"
+#include "BakedTexture.h"
+#include "MipGenerator.h"
+#include "BlockCompression.h"
+#include "GroundLayers.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <set>
+#include <chrono>
+
+static const char* DefaultModels[] = {
+    "assets/models/free-retro-american-car-cartoon-low-poly/source/RetroCar/RetroCar.obj",
+    "assets/models/goblin-3d-model-free/source/GoblinMutantSPDONEFINAL.fbx",
+    "assets/models/22_ Heart/Heart.obj",
+    "assets/models/22_ Heart/Heart.fbx",
+    "assets/models/low_poly_potion.glb",
+    "assets/models/bridge.glb",
+};
+
+// Textures main.cpp loads directly besides the ground layers (model textures are collected
+// from the models)
+static const char* DefaultTextures[] = {
+    "assets/cubemap/px.png",
+    "assets/cubemap/nx.png",
+    "assets/cubemap/py.png",
+    "assets/cubemap/ny.png",
+    "assets/cubemap/pz.png",
+    "assets/cubemap/nz.png",
+};
+
+enum class TextureFormat { Auto, BC1, BC3, BC7, Raw };
+
+static bool ParseTextureFormat(const std::string& name, TextureFormat& out) {
+    if (name == "auto") out = TextureFormat::Auto;
+    else if (name == "bc1") out = TextureFormat::BC1;
+    else if (name == "bc3") out = TextureFormat::BC3;
+    else if (name == "bc7") out = TextureFormat::BC7;
+    else if (name == "raw") out = TextureFormat::Raw;
+    else return false;
+    return true;
+}
+
+static bool IsImagePath(const std::string& path) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    for (char& c : extension) c = (char)tolower((unsigned char)c);
+    return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp";
+}
+
+static bool ParseVertexFormat(const std::string& name, VertexFormat& out) {
+    if (name == "packed") out = VertexFormat::Packed;
+    else if (name == "float") out = VertexFormat::Float;
+    else return false;
+    return true;
+}
+
+// True if every mesh in 'view' was baked with 'vertexFormat'
+static bool HasVertexFormat(const BakedModel::View& view, VertexFormat vertexFormat) {
+    for (uint32_t i = 0; i < view.meshCount(); ++i) {
+        if (view.vertexFormat(i) != vertexFormat) return false;
+    }
+    return true;
+}
+
+// Bake one model (a baked file is up to date if it opens cleanly against its current
+// source and has the requested vertex layout); the texture paths its meshes use are added
+// to 'textures'
+static bool BakeModel(const std::string& sourcePath, bool force, VertexFormat vertexFormat, std::set<std::string>& textures) {
+    std::string bakedPath = BakedModel::PathFor(sourcePath);
+    BakedModel::View existing;
+    if (!force && existing.Open(bakedPath, sourcePath) && HasVertexFormat(existing, vertexFormat)) {
+        for (uint32_t i = 0; i < existing.meshCount(); ++i) {
+            const BakedModel::MeshRecord& rec = existing.mesh(i);
+            for (uint32_t t = 0; t < rec.textureCount; ++t) textures.insert(existing.string(rec.textureOffsets[t]));
+        }
+        std::cout << "Up to date: " << bakedPath << std::endl;
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    ModelData data;
+    if (!ModelImporter::Import(sourcePath, data)) {
+        std::cerr << "Failed to import: " << sourcePath << std::endl;
+        return false;
+    }
+    if (!BakedModel::Write(data, bakedPath, vertexFormat)) {
+        std::cerr << "Failed to write: " << bakedPath << std::endl;
+        return false;
+    }
+
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    for (const auto& mesh : data.meshes) {
+        vertexCount += mesh.vertices.size();
+        indexCount += mesh.indices.size();
+        textures.insert(mesh.texturePaths.begin(), mesh.texturePaths.end());
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "Baked " << sourcePath << " -> " << bakedPath << std::endl;
+    std::cout << "  Meshes: " << data.meshes.size() << ", vertices: " << vertexCount
+              << ", indices: " << indexCount << ", " << (vertexFormat == VertexFormat::Packed ? "packed" : "float")
+              << " vertices (" << elapsed.count() << " ms)" << std::endl;
+    return true;
+}
+
+// Block format 'format' resolves to for an image
+static BlockFormat BlockFormatFor(TextureFormat format, bool hasAlpha) {
+    switch (format) {
+    case TextureFormat::Auto: return hasAlpha ? BlockFormat::BC7 : BlockFormat::BC1;
+    case TextureFormat::BC1: return BlockFormat::BC1;
+    case TextureFormat::BC3: return BlockFormat::BC3;
+    case TextureFormat::BC7: return BlockFormat::BC7;
+    case TextureFormat::Raw: return BlockFormat::None;
+    }
+    return BlockFormat::None;
+}
+
+// Bake one image with its full mip chain. Every texture the game loads is albedo, so
+// images are treated as sRGB colour and filtered in linear space.
+static bool BakeTexture(const std::string& sourcePath, bool force, TextureFormat format) {
+    std::string bakedPath = BakedTexture::PathFor(sourcePath);
+    ImageData existing;
+    if (!force && BakedTexture::Read(bakedPath, sourcePath, existing)) {
+        std::cout << "Up to date: " << bakedPath << std::endl;
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    ImageData image;
+    if (!ImageLoader::Decode(sourcePath, image)) {
+        std::cerr << "Failed to decode: " << sourcePath << std::endl;
+        return false;
+    }
+    image.srgb = true;
+    MipGenerator::BuildChain(image);
+
+    size_t rawBytes = image.pixels.size();
+    for (const auto& mip : image.mips) rawBytes += mip.size();
+    BlockCompression::Compress(image, BlockFormatFor(format, BlockCompression::HasAlpha(image)));
+    size_t bakedBytes = image.pixels.size();
+    for (const auto& mip : image.mips) bakedBytes += mip.size();
+
+    if (!BakedTexture::Write(image, sourcePath, bakedPath)) {
+        std::cerr << "Failed to write: " << bakedPath << std::endl;
+        return false;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "Baked " << sourcePath << " -> " << bakedPath << std::endl;
+    std::cout << "  " << image.width << "x" << image.height << ", " << image.mips.size() + 1 << " levels, "
+              << BlockCompression::FormatName(image.block) << " " << rawBytes / 1024 << " KB -> " << bakedBytes / 1024
+              << " KB (" << elapsed.count() << " ms)" << std::endl;
+    return true;
+}
+
+// True if two baked images can be layers of one texture array
+static bool SameLayout(const ImageData& a, const ImageData& b) {
+    return a.width == b.width && a.height == b.height && a.channels == b.channels &&
+           a.block == b.block && a.mips.size() == b.mips.size();
+}
+
+// The ground samples all its layers from one texture array, which the game only uploads as-is
+// when every layer has the same size, block format and mip count. Bake them as a set: decoded
+// to RGBA, resampled to the largest layer and compressed alike, the last layer being
+// GroundLayers::BridgeOverWater blended from the bridge and lake images.
+static bool BakeGroundLayers(bool force, TextureFormat format) {
+    struct Layer {
+        std::string source; // image the baked file is decoded from and stamped with
+        std::string bakedPath;
+        ImageData image;
+    };
+    std::vector<Layer> layers = {
+        { GroundLayers::Grass, BakedTexture::PathFor(GroundLayers::Grass), {} },
+        { GroundLayers::Lake, BakedTexture::PathFor(GroundLayers::Lake), {} },
+        { GroundLayers::Street, BakedTexture::PathFor(GroundLayers::Street), {} },
+        { GroundLayers::Bridge, BakedTexture::PathFor(GroundLayers::BridgeOverWater), {} },
+    };
+    Layer& lake = layers[1];
+    Layer& bridge = layers.back();
+
+    if (!force) {
+        bool upToDate = true;
+        for (Layer& layer : layers) {
+            upToDate = upToDate && BakedTexture::Read(layer.bakedPath, layer.source, layer.image) &&
+                       SameLayout(layer.image, layers[0].image);
+        }
+        // The blend is stamped with the bridge image only, so check it against the lake as well
+        // (a missing lake image has nothing newer to offer)
+        std::error_code lakeError, blendError;
+        auto lakeTime = std::filesystem::last_write_time(lake.source, lakeError);
+        auto blendTime = std::filesystem::last_write_time(bridge.bakedPath, blendError);
+        upToDate = upToDate && !blendError && (lakeError || lakeTime <= blendTime);
+        if (upToDate) {
+            std::cout << "Up to date: ground layers" << std::endl;
+            return true;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    int width = 0, height = 0;
+    for (Layer& layer : layers) {
+        layer.image = ImageData();
+        if (!ImageLoader::Decode(layer.source, layer.image, 4)) {
+            // Same stand-in the game uses, so the set stays complete and uploads as-is
+            std::cerr << "Warning: baking a solid colour for missing ground layer " << layer.source << std::endl;
+            GroundLayers::FillMissing(layer.source, layer.image, 4);
+        }
+        width = std::max(width, layer.image.width);
+        height = std::max(height, layer.image.height);
+    }
+    bool hasAlpha = false;
+    for (Layer& layer : layers) {
+        MipGenerator::Resize(layer.image, width, height);
+        hasAlpha = hasAlpha || BlockCompression::HasAlpha(layer.image);
+    }
+    GroundLayers::BlendBridgeOverWater(bridge.image, lake.image);
+
+    BlockFormat block = BlockFormatFor(format, hasAlpha);
+    for (Layer& layer : layers) {
+        layer.image.srgb = true;
+        MipGenerator::BuildChain(layer.image);
+        BlockCompression::Compress(layer.image, block);
+        if (!BakedTexture::Write(layer.image, layer.source, layer.bakedPath)) {
+            std::cerr << "Failed to write: " << layer.bakedPath << std::endl;
+            return false;
+        }
+        std::cout << "Baked " << layer.source << " -> " << layer.bakedPath << std::endl;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "  Ground layers: " << layers.size() << " x " << width << "x" << height << ", "
+              << layers[0].image.mips.size() + 1 << " levels, " << BlockCompression::FormatName(block)
+              << " (" << elapsed.count() << " ms)" << std::endl;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    bool force = false;
+    TextureFormat format = TextureFormat::Auto;
+    VertexFormat vertexFormat = VertexFormat::Packed;
+    bool groundLayers = false;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--force") {
+            force = true;
+        } else if (arg == "--ground") {
+            groundLayers = true;
+        } else if (arg == "--format" && i + 1 < argc) {
+            if (!ParseTextureFormat(argv[++i], format)) {
+                std::cerr << "Unknown texture format: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--vertices" && i + 1 < argc) {
+            if (!ParseVertexFormat(argv[++i], vertexFormat)) {
+                std::cerr << "Unknown vertex format: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    std::vector<std::string> models;
+    std::set<std::string> textures;
+    for (const auto& path : paths) {
+        if (IsImagePath(path)) textures.insert(path);
+        else models.push_back(path);
+    }
+    if (paths.empty()) {
+        groundLayers = true;
+        models.assign(std::begin(DefaultModels), std::end(DefaultModels));
+        textures.insert(std::begin(DefaultTextures), std::end(DefaultTextures));
+    }
+
+    int modelFailures = 0;
+    for (const auto& path : models) {
+        if (!BakeModel(path, force, vertexFormat, textures)) modelFailures++;
+    }
+    int textureFailures = 0;
+    for (const auto& path : textures) {
+        if (!BakeTexture(path, force, format)) textureFailures++;
+    }
+
+    bool groundFailed = groundLayers && !BakeGroundLayers(force, format);
+
+    std::cout << models.size() - modelFailures << "/" << models.size() << " models, "
+              << textures.size() - textureFailures << "/" << textures.size() << " textures baked"
+              << (groundFailed ? ", ground layers failed" : "") << std::endl;
+    return modelFailures + textureFailures == 0 && !groundFailed ? 0 : 1;
+}
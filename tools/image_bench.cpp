@@ -0,0 +1,78 @@
+// image_bench - measures image decode time for the textures the game loads at startup.
+//
+// Usage: image_bench [image paths...]
+// With no paths, decodes the skybox faces and ground textures. Each image is decoded once
+// serially (per-image timings), then all of them at once on a ThreadPool, the way the game's
+// AssetLoader does. Run it from the directory that contains assets/.
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "ImageLoader.h"
+#include "ThreadPool.h"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+
+static const char* DefaultImages[] = {
+    "assets/cubemap/px.png",
+    "assets/cubemap/nx.png",
+    "assets/cubemap/py.png",
+    "assets/cubemap/ny.png",
+    "assets/cubemap/pz.png",
+    "assets/cubemap/nz.png",
+    "assets/textures/grass.jpg",
+    "assets/textures/lake.png",
+    "assets/textures/street.jpg",
+};
+
+using Clock = std::chrono::steady_clock;
+
+static double MillisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) paths.push_back(argv[i]);
+    if (paths.empty()) {
+        paths.assign(std::begin(DefaultImages), std::end(DefaultImages));
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+
+    // Serial: one image at a time, per-image timings
+    double serialTotal = 0.0;
+    int failures = 0;
+    for (const auto& path : paths) {
+        ImageData image;
+        auto start = Clock::now();
+        bool ok = ImageLoader::Decode(path, image);
+        double ms = MillisecondsSince(start);
+        serialTotal += ms;
+        if (!ok) {
+            failures++;
+            continue;
+        }
+        double megapixels = (double)image.width * image.height / 1e6;
+        std::cout << path << ": " << image.width << "x" << image.height << "x" << image.channels << ", "
+                  << ms << " ms (" << megapixels / (ms / 1000.0) << " MP/s)" << std::endl;
+    }
+
+    // Parallel: every image as its own job on the pool
+    ThreadPool pool;
+    std::vector<ImageData> images(paths.size());
+    auto start = Clock::now();
+    for (size_t i = 0; i < paths.size(); ++i) {
+        pool.Submit([&paths, &images, i]() { ImageLoader::Decode(paths[i], images[i]); });
+    }
+    pool.WaitIdle();
+    double parallelTotal = MillisecondsSince(start);
+
+    std::cout << "Serial:   " << serialTotal << " ms for " << paths.size() << " images" << std::endl;
+    std::cout << "Parallel: " << parallelTotal << " ms on " << pool.WorkerCount() << " workers ("
+              << (parallelTotal > 0.0 ? serialTotal / parallelTotal : 0.0) << "x)" << std::endl;
+    return failures == 0 ? 0 : 1;
+}